@@ -4,6 +4,13 @@
 #include <stack>
 #include <vector>
 
+#define BINARY_HEAP_NO_MAIN
+#include "../Heap/BinaryHeap.cpp"
+#define RADIX_HEAP_NO_MAIN
+#include "../Heap/RadixHeap.cpp"
+#define BUCKET_QUEUE_NO_MAIN
+#include "../Heap/BucketQueue.cpp"
+
 #define MAX_SIZE 100
 #define MAX 0x7fffffff
 
@@ -269,22 +276,79 @@ void kruskal(Graph* g) {
     }
 }
 
+// dijkstra使用的优先队列
+// PRIORITY_QUEUE是懒删除：距离变小就再压入一次，旧的记录留在堆里，出队时靠visited跳过，堆里最多有O(E)个元素
+// INDEXED_HEAP每个顶点在堆里至多一个位置，距离变小时decreaseKey，堆的大小不超过V，每个顶点只出队一次
+// 后两种利用了出队的距离单调不减、边权是非负整数，每次操作均摊O(1)，没有O(log n)的比较
+enum DijkstraQueue {
+    PRIORITY_QUEUE,    // std::priority_queue，二叉堆
+    INDEXED_HEAP,      // 带位置表的二叉堆，支持decreaseKey（Heap/BinaryHeap.cpp的IndexedMinHeap）
+    RADIX_HEAP,        // 基数堆（Heap/RadixHeap.cpp）
+    BUCKET_QUEUE       // 桶队列，即Dial算法（Heap/BucketQueue.cpp），桶数为最大边权+1，边权很大时用基数堆
+};
+
 // 最短路径 dijkstra算法
 // Dijkstra算法：从起点开始，逐步扩展到所有顶点，找到最短路径
 // 注意：Dijkstra算法只能用于非负权图，且不能处理负权边
 // 优先队列
-void dijkstra(Graph* g) {
+// 返回起点A到各顶点的最短距离，parent中记录最短路径上的前驱
+std::vector<int> dijkstraDistances(Graph* g, DijkstraQueue queue, std::vector<int>& parent) {
+    resetVisited();    // visited是全局的，上一次调用（或dfs/bfs）留下的标记会让顶点被直接跳过
     std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;    // 最小堆
+    IndexedMinHeap<int> indexed(g->vertex_num);
+    RadixHeap<int> radix;
+    int max_weight = 0;    // 桶队列需要知道最大边权
+    if (queue == BUCKET_QUEUE) {
+        for (int i = 0; i < g->vertex_num; ++i) {
+            for (int j = 0; j < g->vertex_num; ++j) {
+                if (g->arc[i][j] != MAX) {
+                    max_weight = std::max(max_weight, g->arc[i][j]);
+                }
+            }
+        }
+    }
+    BucketQueue<int> bucket(max_weight);
+    // 四种队列的入队、出队和判空，出队返回顶点
+    // 索引堆的入队：顶点不在堆中就插入，在堆中就把它的距离减小为d
+    auto push = [&](int d, int v) {
+        if (queue == INDEXED_HEAP) {
+            indexed.insertOrDecrease(v, d);
+        } else if (queue == RADIX_HEAP) {
+            radix.insert(d, v);
+        } else if (queue == BUCKET_QUEUE) {
+            bucket.insert(d, v);
+        } else {
+            pq.push({d, v});
+        }
+    };
+    auto pop = [&]() {
+        if (queue == INDEXED_HEAP) {
+            return indexed.extractMin();
+        } else if (queue == RADIX_HEAP) {
+            return radix.extractMin().second;
+        } else if (queue == BUCKET_QUEUE) {
+            return bucket.extractMin().second;
+        }
+        int v = pq.top().second;
+        pq.pop();
+        return v;
+    };
+    auto empty = [&]() {
+        if (queue == INDEXED_HEAP) {
+            return indexed.isEmpty();
+        }
+        return queue == RADIX_HEAP ? radix.isEmpty() : queue == BUCKET_QUEUE ? bucket.isEmpty() : pq.empty();
+    };
+
     std::vector<int> dist(g->vertex_num, MAX);     // 初始化距离数组，初始值为最大值
-    std::vector<int> parent(g->vertex_num, -1);    // 记录前驱节点，用于最后输出路径
+    parent.assign(g->vertex_num, -1);              // 记录前驱节点，用于最后输出路径
     int start = 0;                                 // 起点索引，这里假设从顶点A开始
     dist[start] = 0;                               // 起点到自己的距离为0
-    pq.push({0, start});                           // 将起点加入优先队列，
+    push(0, start);                                // 将起点加入优先队列，
     // 优先队列中的元素是一个pair，第一个元素是距离，第二个元素是顶点索引
     // curr代表当前处理的顶点，next是下一步待扩展的顶点
-    while (!pq.empty()) {
-        int curr = pq.top().second;    // 获取当前距离最小的顶点
-        pq.pop();
+    while (!empty()) {
+        int curr = pop();    // 获取当前距离最小的顶点
 
         if (visited[curr]) {
             continue;    // 如果已经访问过，跳过
@@ -302,12 +366,21 @@ void dijkstra(Graph* g) {
                 if (new_dist < dist[next]) {                               // 如果新距离小于原距离
                     dist[next] = new_dist;                                 // 更新距离
                     parent[next] = curr;                                   // 更新前驱节点
-                    pq.push({new_dist, next});                             // 将新距离和顶点加入优先队列
+                    push(new_dist, next);                                  // 将新距离和顶点加入优先队列
                 }
             }
         }
     }
 
+    return dist;
+}
+
+// 求出最短路径并输出
+void dijkstra(Graph* g, DijkstraQueue queue = PRIORITY_QUEUE) {
+    std::vector<int> parent;
+    std::vector<int> dist = dijkstraDistances(g, queue, parent);
+    int start = 0;
+
     // 输出最短路径
     for (int i = 1; i < g->vertex_num; ++i) {
         if (dist[i] == MAX) {
@@ -504,5 +577,16 @@ int main() {
     AdjGraph adj_g;
     createAdjGraph(&g, &adj_g);    // 创建邻接表
     criticalPath(&adj_g);
+    printf("\n");
+
+    // 四种优先队列求出的最短距离必须相同
+    dijkstra(&g);
+    std::vector<int> parent;
+    std::vector<int> expected = dijkstraDistances(&g, PRIORITY_QUEUE, parent);
+    const char* names[] = {"priority_queue", "indexed heap", "radix heap", "bucket queue"};
+    for (DijkstraQueue queue : {INDEXED_HEAP, RADIX_HEAP, BUCKET_QUEUE}) {
+        bool same = dijkstraDistances(&g, queue, parent) == expected;
+        printf("Dijkstra with %s: %s\n", names[queue], same ? "same distances" : "DISTANCES DIFFER");
+    }
     return 0;
 }
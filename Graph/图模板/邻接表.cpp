@@ -41,12 +41,40 @@
 // 5. 求连通分量（无向图）
 // 6. prim最小生成树（无向图）
 
+// dijkstra和prim的堆有以下选择（HeapMode）：
+// 1. LAZY：std::priority_queue + 惰性删除。距离变小时直接再压入一份，旧的留在堆里，弹出时用vis跳过
+//    堆里最多有O(E)个元素，其中大部分是过期的，每个过期元素都要付出一次压入和一次弹出
+// 2. INDEXED：索引堆（Heap/BinaryHeap.cpp中的IndexedMinHeap）。每个顶点在堆里最多一份，距离变小时decreaseKey
+//    堆的大小不超过V，每个顶点恰好弹出一次，也不需要vis判断
+// 3. RADIX：基数堆（Heap/RadixHeap.cpp），只能用于dijkstra
+// 4. BUCKET：桶队列，即Dial算法（Heap/BucketQueue.cpp），只能用于dijkstra
+//    这两种利用了dijkstra出堆的距离单调不减、边权是非负整数，每次操作均摊O(1)，没有O(log n)的比较
+//    用法和LAZY一样是重复压入+弹出时跳过。桶队列的桶数等于最大边权+1，边权很大时应该用基数堆
+//    prim出堆的边权不是单调的，不能用这两种
+// 各种方式的结果完全相同，lastHeapStats()可以看到压入、弹出次数和堆的峰值大小的差别
+
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <queue>
+#include <stdexcept>
+
+#define BINARY_HEAP_NO_MAIN
+#include "../../Heap/BinaryHeap.cpp"
+#define RADIX_HEAP_NO_MAIN
+#include "../../Heap/RadixHeap.cpp"
+#define BUCKET_QUEUE_NO_MAIN
+#include "../../Heap/BucketQueue.cpp"
 
 using namespace std;
 
+enum class HeapMode {
+    LAZY,       // 优先队列 + 惰性删除
+    INDEXED,    // 索引堆 + decreaseKey
+    RADIX,      // 基数堆 + 惰性删除，仅dijkstra
+    BUCKET      // 桶队列 + 惰性删除，仅dijkstra
+};
+
 class Graph {
 private:
     // 边结点结构体，相当于结合了e,ne,w
@@ -74,9 +102,141 @@ private:
     vector<Node> nodes;    // 节点数组，拉出来“二维链表”，也就是邻接表主体
     int node_num;
     int edge_num;
+    int max_weight = 0;    // 加过的边中最大的边权，桶队列的桶数由它决定
 
 public:
-    static const int MAX = 0x3f3f3f3f;
+    static constexpr int MAX = 0x3f3f3f3f;
+
+    // 最近一次dijkstra/prim中堆的使用情况
+    struct HeapStats {
+        long long pushes;      // 压入次数（索引堆中包括decreaseKey）
+        long long pops;        // 弹出次数（惰性删除时包括弹出后被跳过的过期元素）
+        int peak_size;         // 堆的峰值大小
+    };
+
+private:
+    HeapStats heap_stats = {0, 0, 0};
+
+    // dijkstra的两种实现，参数已经由dijkstra检查过
+    int dijkstraLazy(int start_node, int end_node) {
+        vector<int> dist(node_num + 1, MAX);
+        dist[start_node] = 0;
+        vector<bool> vis(node_num + 1, false);
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> heap;
+        heap.push({0, start_node});
+        heap_stats.pushes++;
+
+        while (!heap.empty()) {
+            heap_stats.peak_size = max(heap_stats.peak_size, (int)heap.size());
+            auto t = heap.top();
+            heap.pop();
+            heap_stats.pops++;
+
+            int curr_dist = t.first;
+            int curr_node = t.second;
+
+            // 剪枝
+            if (curr_node == end_node) {
+                return curr_dist;
+            }
+
+            if (vis[curr_node]) {
+                continue;
+            }
+            vis[curr_node] = true;
+
+            for (Edge* e = nodes[curr_node].head; e; e = e->next) {
+                int to = e->to;
+                int weight = e->weight;
+
+                if (dist[to] > curr_dist + weight) {
+                    dist[to] = curr_dist + weight;
+                    heap.push({dist[to], to});
+                    heap_stats.pushes++;
+                }
+            }
+        }
+
+        return dist[end_node] == MAX ? -1 : dist[end_node];
+    }
+
+    int dijkstraIndexed(int start_node, int end_node) {
+        vector<int> dist(node_num + 1, MAX);
+        dist[start_node] = 0;
+        // 顶点号直接作为堆中的编号，堆的大小不超过顶点数
+        IndexedMinHeap<int> heap(node_num + 1);
+        heap.insert(start_node, 0);
+        heap_stats.pushes++;
+
+        while (!heap.isEmpty()) {
+            heap_stats.peak_size = max(heap_stats.peak_size, heap.size());
+            int curr_dist = heap.peekKey();
+            int curr_node = heap.extractMin();
+            heap_stats.pops++;
+
+            // 剪枝
+            if (curr_node == end_node) {
+                return curr_dist;
+            }
+
+            // 不需要vis：弹出的顶点距离已经是最短的（边权非负），之后不会再被松弛，也就不会再进堆
+            for (Edge* e = nodes[curr_node].head; e; e = e->next) {
+                int to = e->to;
+                int weight = e->weight;
+
+                if (dist[to] > curr_dist + weight) {
+                    dist[to] = curr_dist + weight;
+                    heap.insertOrDecrease(to, dist[to]);    // 不在堆中就插入，在堆中就减小它的key
+                    heap_stats.pushes++;
+                }
+            }
+        }
+
+        return dist[end_node] == MAX ? -1 : dist[end_node];
+    }
+
+    // 单调优先队列（RadixHeap、BucketQueue）版本，流程和dijkstraLazy一样
+    // 边权非负时，新压入的距离不小于刚出堆的距离，满足单调队列的要求
+    template<class MonotoneQueue>
+    int dijkstraMonotone(MonotoneQueue& heap, int start_node, int end_node) {
+        vector<int> dist(node_num + 1, MAX);
+        dist[start_node] = 0;
+        vector<bool> vis(node_num + 1, false);
+        heap.insert(0, start_node);
+        heap_stats.pushes++;
+
+        while (!heap.isEmpty()) {
+            heap_stats.peak_size = max(heap_stats.peak_size, heap.size());
+            auto t = heap.extractMin();
+            heap_stats.pops++;
+
+            int curr_dist = t.first;
+            int curr_node = t.second;
+
+            // 剪枝
+            if (curr_node == end_node) {
+                return curr_dist;
+            }
+
+            if (vis[curr_node]) {
+                continue;
+            }
+            vis[curr_node] = true;
+
+            for (Edge* e = nodes[curr_node].head; e; e = e->next) {
+                int to = e->to;
+                int weight = e->weight;
+
+                if (dist[to] > curr_dist + weight) {
+                    dist[to] = curr_dist + weight;
+                    heap.insert(dist[to], to);
+                    heap_stats.pushes++;
+                }
+            }
+        }
+
+        return dist[end_node] == MAX ? -1 : dist[end_node];
+    }
 
 public:
     Graph(int n, int e)
@@ -106,6 +266,7 @@ public:
         new_edge->next = nodes[from].head;
         nodes[from].head = new_edge;
         nodes[to].in++;
+        max_weight = max(max_weight, weight);
     }
 
     // 注意，如果为无向图，需要删除两次边
@@ -164,7 +325,12 @@ public:
         return topo_order.size() == node_num;
     }
 
-    int dijkstra(int start_node = 1, int end_node = -1) {
+    // 最近一次dijkstra/prim的堆统计
+    const HeapStats& lastHeapStats() const {
+        return heap_stats;
+    }
+
+    int dijkstra(int start_node = 1, int end_node = -1, HeapMode mode = HeapMode::LAZY) {
         if (start_node < 1 || start_node > node_num || (end_node != -1 && (end_node < 1 || end_node > node_num))) {
             return -2;    // 输入节点不合法
         }
@@ -172,41 +338,21 @@ public:
             end_node = node_num;
         }
 
-        vector<int> dist(node_num + 1, MAX);
-        dist[start_node] = 0;
-        vector<bool> vis(node_num + 1, false);
-        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> heap;
-        heap.push({0, start_node});
-
-        while (!heap.empty()) {
-            auto t = heap.top();
-            heap.pop();
-
-            int curr_dist = t.first;
-            int curr_node = t.second;
-
-            // 剪枝
-            if (curr_node == end_node) {
-                return curr_dist;
-            }
-
-            if (vis[curr_node]) {
-                continue;
-            }
-            vis[curr_node] = true;
-
-            for (Edge* e = nodes[curr_node].head; e; e = e->next) {
-                int to = e->to;
-                int weight = e->weight;
-
-                if (dist[to] > curr_dist + weight) {
-                    dist[to] = curr_dist + weight;
-                    heap.push({dist[to], to});
-                }
-            }
+        heap_stats = {0, 0, 0};
+        switch (mode) {
+        case HeapMode::INDEXED:
+            return dijkstraIndexed(start_node, end_node);
+        case HeapMode::RADIX: {
+            RadixHeap<int> heap;
+            return dijkstraMonotone(heap, start_node, end_node);
+        }
+        case HeapMode::BUCKET: {
+            BucketQueue<int> heap(max_weight);
+            return dijkstraMonotone(heap, start_node, end_node);
+        }
+        default:
+            return dijkstraLazy(start_node, end_node);
         }
-
-        return dist[end_node] == MAX ? -1 : dist[end_node];
     }
 
     // 层序遍历
@@ -377,30 +523,50 @@ public:
 
     // 使用优先队列的prim算法，对于稀疏图来说性能也很高
     // 注意，必须为无向图才可使用
-    int prim() {
+    // 只支持LAZY和INDEXED，其他模式抛出std::invalid_argument
+    int prim(HeapMode mode = HeapMode::LAZY) {
+        if (mode != HeapMode::LAZY && mode != HeapMode::INDEXED) {
+            throw invalid_argument("prim: pop order is not monotone, use LAZY or INDEXED heap mode.");
+        }
+
         // min_weight[i]存储的是当前集合中所有点到外部点i的所有边中，权值最小的那条边的权值。
         vector<int> min_weight(node_num + 1, MAX);
         // 维护最小生成树mst集合
         vector<bool> in_mst(node_num + 1, false);
         // 高效地维护所有外部点到当前集合的最小距离，
+        // LAZY模式用优先队列，同一个点可能有多份；INDEXED模式用索引堆，每个点最多一份
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> heap;
+        IndexedMinHeap<int> indexed_heap(mode == HeapMode::INDEXED ? node_num + 1 : 0);
 
+        heap_stats = {0, 0, 0};
         min_weight[1] = 0;
-        heap.push({0, 1});
+        if (mode == HeapMode::INDEXED) {
+            indexed_heap.insert(1, 0);
+        } else {
+            heap.push({0, 1});
+        }
+        heap_stats.pushes++;
 
         int tot_weight = 0;
         int node_joined = 0;
 
-        while (!heap.empty()) {
+        while (mode == HeapMode::INDEXED ? !indexed_heap.isEmpty() : !heap.empty()) {
             // 取出当前距离集合最近的点
-            auto t = heap.top();
-            heap.pop();
-
-            int curr_weight = t.first;
-            int curr_node = t.second;
+            int curr_weight, curr_node;
+            if (mode == HeapMode::INDEXED) {
+                heap_stats.peak_size = max(heap_stats.peak_size, indexed_heap.size());
+                curr_weight = indexed_heap.peekKey();
+                curr_node = indexed_heap.extractMin();
+            } else {
+                heap_stats.peak_size = max(heap_stats.peak_size, (int)heap.size());
+                curr_weight = heap.top().first;
+                curr_node = heap.top().second;
+                heap.pop();
+            }
+            heap_stats.pops++;
 
             if (in_mst[curr_node]) {
-                continue;
+                continue;    // 只有LAZY模式会弹出过期的元素
             }
 
             in_mst[curr_node] = true;
@@ -417,7 +583,12 @@ public:
                 // curr_node已经在集合中了，且e又与之相连，那么直接加上weight，就是to到集合的距离
                 if (!in_mst[to] && min_weight[to] > weight) {
                     min_weight[to] = weight;
-                    heap.push({weight, to});
+                    if (mode == HeapMode::INDEXED) {
+                        indexed_heap.insertOrDecrease(to, weight);
+                    } else {
+                        heap.push({weight, to});
+                    }
+                    heap_stats.pushes++;
                 }
             }
         }
@@ -429,9 +600,48 @@ public:
     }
 };
 
+// 在随机生成的无向稀疏图上比较各种堆：结果必须相同，比较压入、弹出次数、堆的峰值大小和耗时
+// 先连一棵随机生成树保证连通，再随机加边，边权在[1, 1000]之间
+void benchmarkHeapModes(int n, int m) {
+    Graph graph(n, 2 * m);
+    unsigned seed = 2024;
+    auto next_rand = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    for (int i = 0; i < m; ++i) {
+        int from = i + 2 <= n ? i + 2 : next_rand() % n + 1;
+        int to = i + 2 <= n ? next_rand() % (i + 1) + 1 : next_rand() % n + 1;
+        int weight = next_rand() % 1000 + 1;
+        graph.addEdge(from, to, weight);
+        graph.addEdge(to, from, weight);
+    }
+
+    cout << "Random graph: " << n << " vertices, " << m << " undirected edges" << endl;
+    const char* mode_names[] = {" lazy   ", " indexed", " radix  ", " bucket "};
+    for (int algorithm = 0; algorithm < 2; ++algorithm) {
+        for (HeapMode mode : {HeapMode::LAZY, HeapMode::INDEXED, HeapMode::RADIX, HeapMode::BUCKET}) {
+            if (algorithm == 1 && mode != HeapMode::LAZY && mode != HeapMode::INDEXED) {
+                continue;    // prim只能用前两种
+            }
+            auto start = chrono::steady_clock::now();
+            int result = algorithm == 0 ? graph.dijkstra(1, n, mode) : graph.prim(mode);
+            auto end = chrono::steady_clock::now();
+            const Graph::HeapStats& stats = graph.lastHeapStats();
+            cout << "  " << (algorithm == 0 ? "dijkstra" : "prim    ") << mode_names[static_cast<int>(mode)]
+                 << ": result " << result << ", pushes " << stats.pushes << ", pops " << stats.pops << ", peak heap "
+                 << stats.peak_size << ", " << chrono::duration<double, milli>(end - start).count() << " ms" << endl;
+        }
+    }
+}
+
 int main() {
     int n, m;
-    cin >> n >> m;
+    if (!(cin >> n >> m)) {
+        // 没有输入时，在随机图上比较各种堆
+        benchmarkHeapModes(200000, 1000000);
+        return 0;
+    }
     Graph graph(n, m);
 
     for (int i = 0; i < m; ++i) {
@@ -440,5 +650,12 @@ int main() {
         graph.addEdge(from, to, weight);
     }
 
+    // 1到n的最短路，两种堆的结果相同
+    int lazy_dist = graph.dijkstra(1, n, HeapMode::LAZY);
+    long long lazy_pops = graph.lastHeapStats().pops;
+    int indexed_dist = graph.dijkstra(1, n, HeapMode::INDEXED);
+    cout << "dijkstra(1, " << n << "): " << lazy_dist << " (lazy, " << lazy_pops << " pops), " << indexed_dist << " (indexed, "
+         << graph.lastHeapStats().pops << " pops)" << endl;
+
     return 0;
 }
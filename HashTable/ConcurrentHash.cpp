@@ -0,0 +1,255 @@
+// 分片（sharded）并发哈希表，基于 SepChaining.cpp 的分离链接哈希表
+
+// SepChaining.cpp 中的 HashTable 没有任何同步措施，多个线程同时读写会出现数据竞争
+// 最简单的办法是整张表加一把锁，但这样所有线程都在抢同一把锁，线程越多越慢
+// 分片的思路：把表拆成 N 个互相独立的子表（分片），每个分片有自己的锁
+//    1. 元素属于哪个分片由哈希值的高位决定，同一个元素永远落在同一个分片
+//    2. 不同分片上的操作互不干扰，N 个分片最多允许 N 个写者同时工作
+//    3. 每个分片各自 rehash，某个分片扩容时只会阻塞落在这个分片上的操作
+// 分片选择用的是混合后哈希值的高位，而分片内部的桶下标用的是原始哈希值取模，二者互不相关，
+// 否则同一个分片里的元素会全部挤在少数几个桶里
+
+// 锁的选择（模板参数 Lock）：
+//    std::shared_mutex：读写锁，contains 加共享锁，多个读者可以同时读同一个分片
+//    SpinLock：自旋锁，读写都加独占锁。临界区很短时，自旋比进入内核睡眠便宜得多
+// 分片内部固定使用一次性 rehash：渐进式 rehash 会在 contains 中推进迁移（修改内部状态），
+// 那样的话 contains 就不能只加共享锁了
+
+#define SEP_CHAINING_NO_MAIN
+#include "SepChaining.cpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// --- 自旋锁 ---
+
+// 基于 std::atomic_flag 的自旋锁，同时提供 lock_shared/unlock_shared，
+// 这样它和 std::shared_mutex 的接口一致，可以直接作为模板参数替换（共享锁退化为独占锁）
+class SpinLock {
+public:
+    void lock() {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();    // 拿不到锁时让出时间片，线程数超过核数时不至于空转
+        }
+    }
+
+    void unlock() {
+        flag.clear(std::memory_order_release);
+    }
+
+    void lock_shared() {
+        lock();
+    }
+
+    void unlock_shared() {
+        unlock();
+    }
+
+private:
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+};
+
+// --- 模板类 `ConcurrentHashTable` ---
+
+template<class HashedObj, class SizePolicy = PrimeSizePolicy, class Lock = std::shared_mutex>
+class ConcurrentHashTable {
+public:
+    // 构造函数：shardCount 向上取整为 2 的幂，initialSize 平均分给每个分片
+    explicit ConcurrentHashTable(int shardCount = 16, int initialSize = 101) {
+        shardBits = 0;
+        while ((1 << shardBits) < shardCount) {
+            shardBits++;
+        }
+        numShards = 1 << shardBits;
+        shards.reset(new Shard[numShards]);
+        for (int i = 0; i < numShards; ++i) {
+            shards[i].table = HashTable<HashedObj, SizePolicy>(std::max(1, initialSize / numShards), RehashMode::ALL_AT_ONCE);
+        }
+    }
+
+    // 检查元素是否存在（共享锁）
+    bool contains(const HashedObj &x) const {
+        Shard &shard = shardFor(x);
+        std::shared_lock<Lock> guard(shard.lock);
+        return shard.table.contains(x);
+    }
+
+    // 插入元素（独占锁），需要扩容时只会在这个分片内部 rehash
+    bool insert(const HashedObj &x) {
+        Shard &shard = shardFor(x);
+        std::unique_lock<Lock> guard(shard.lock);
+        return shard.table.insert(x);
+    }
+
+    // 删除元素（独占锁）
+    bool remove(const HashedObj &x) {
+        Shard &shard = shardFor(x);
+        std::unique_lock<Lock> guard(shard.lock);
+        return shard.table.remove(x);
+    }
+
+    // 清空所有分片
+    void makeEmpty() {
+        for (int i = 0; i < numShards; ++i) {
+            std::unique_lock<Lock> guard(shards[i].lock);
+            shards[i].table.makeEmpty();
+        }
+    }
+
+    // 获取元素总数
+    // 依次锁住每个分片读取大小，并发修改时得到的只是一个近似值（各分片不是在同一时刻读取的）
+    int size() const {
+        int total = 0;
+        for (int i = 0; i < numShards; ++i) {
+            std::shared_lock<Lock> guard(shards[i].lock);
+            total += shards[i].table.size();
+        }
+        return total;
+    }
+
+    // 获取分片数量
+    int shardCount() const {
+        return numShards;
+    }
+
+private:
+    // 每个分片独占一个 cache line 的起始位置，避免相邻分片的锁落在同一个 cache line 上（伪共享）
+    struct alignas(64) Shard {
+        mutable Lock lock;
+        HashTable<HashedObj, SizePolicy> table;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    int numShards;
+    int shardBits;
+
+    // 用混合后哈希值的最高 shardBits 位选择分片
+    Shard &shardFor(const HashedObj &x) const {
+        if (shardBits == 0) {
+            return shards[0];
+        }
+        uint64_t h = mixHash(static_cast<uint64_t>(std::hash<HashedObj>{}(x)));
+        return shards[h >> (64 - shardBits)];
+    }
+};
+
+// --- 线程扩展性测试 ---
+
+// 预先插入 KEY_RANGE / 2 个元素，然后 threads 个线程各自执行 opsPerThread 次随机操作：
+// readPercent% 的 contains，其余一半 insert、一半 remove，key 在 [0, KEY_RANGE) 中均匀分布
+// 返回吞吐量（百万次操作/秒）
+template<class Table>
+double runWorkload(Table &table, int threads, int readPercent, int opsPerThread) {
+    const int KEY_RANGE = 1 << 16;
+    table.makeEmpty();
+    for (int k = 0; k < KEY_RANGE; k += 2) {
+        table.insert(k);
+    }
+
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, &go, t, readPercent, opsPerThread]() {
+            unsigned seed = 88172645u * (t + 1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < opsPerThread; ++i) {
+                // xorshift32 伪随机数，每个线程独立，不共享任何状态
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                int key = static_cast<int>(seed % KEY_RANGE);
+                int op = static_cast<int>((seed >> 16) % 100);
+                if (op < readPercent) {
+                    table.contains(key);
+                } else if (op % 2 == 0) {
+                    table.insert(key);
+                } else {
+                    table.remove(key);
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &w : workers) {
+        w.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(threads) * opsPerThread / seconds / 1e6;
+}
+
+// 对一种配置，在不同线程数和读写比例下跑一遍，打印吞吐量
+template<class Table>
+void benchmarkScaling(const char *name, Table &table, int maxThreads, int opsPerThread) {
+    std::cout << name << " (" << table.shardCount() << " shards)" << std::endl;
+    for (int readPercent : {50, 90, 99}) {
+        std::cout << "  read " << readPercent << "%:";
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            std::cout << "  " << threads << "T=" << runWorkload(table, threads, readPercent, opsPerThread);
+        }
+        std::cout << "  (Mops/s)" << std::endl;
+    }
+}
+
+// --- 主函数测试 ---
+
+int main(int argc, char *argv[]) {
+    // 1. 基本功能
+    std::cout << "--- Testing ConcurrentHashTable ---" << std::endl;
+    ConcurrentHashTable<std::string> stringTable(4);
+    stringTable.insert("apple");
+    stringTable.insert("banana");
+    stringTable.insert("cherry");
+    std::cout << "Contains 'banana': " << (stringTable.contains("banana") ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 'banana': " << (stringTable.remove("banana") ? "OK" : "Not found") << std::endl;
+    std::cout << "Contains 'banana': " << (stringTable.contains("banana") ? "Yes" : "No") << std::endl;
+    std::cout << "Size: " << stringTable.size() << std::endl;
+
+    // 2. 多线程正确性：每个线程插入自己的一段 key，再删掉其中的偶数
+    std::cout << "\n--- Concurrent insert/remove check ---" << std::endl;
+    ConcurrentHashTable<int> intTable(16);
+    const int THREADS = 8, PER_THREAD = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&intTable, t]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                intTable.insert(t * PER_THREAD + i);
+            }
+            for (int i = 0; i < PER_THREAD; i += 2) {
+                intTable.remove(t * PER_THREAD + i);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    bool ok = intTable.size() == THREADS * PER_THREAD / 2;
+    for (int k = 0; k < THREADS * PER_THREAD; ++k) {
+        ok &= intTable.contains(k) == (k % 2 == 1);
+    }
+    std::cout << "Size: " << intTable.size() << ", check: " << (ok ? "OK" : "FAILED") << std::endl;
+
+    // 3. 线程扩展性：1 ~ 64 线程，不同读写比例
+    // 单分片就相当于整张表一把锁，作为对照
+    // 可以用命令行参数指定最大线程数和每个线程的操作次数，例如 ./ConcurrentHash 64 200000
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 64;
+    int opsPerThread = argc > 2 ? std::atoi(argv[2]) : 50000;
+    std::cout << "\n--- Thread scaling benchmark (hardware threads: " << std::thread::hardware_concurrency() << ") ---" << std::endl;
+
+    ConcurrentHashTable<int> globalLock(1);
+    benchmarkScaling("shared_mutex, single shard", globalLock, maxThreads, opsPerThread);
+    ConcurrentHashTable<int> rwSharded(64);
+    benchmarkScaling("shared_mutex, sharded", rwSharded, maxThreads, opsPerThread);
+    ConcurrentHashTable<int, PrimeSizePolicy, SpinLock> spinSharded(64);
+    benchmarkScaling("SpinLock, sharded", spinSharded, maxThreads, opsPerThread);
+
+    return 0;
+}
@@ -0,0 +1,368 @@
+// 布谷鸟哈希（Cuckoo Hashing）：分桶（4 路）+ 两个哈希函数 + 溢出暂存区（stash）
+
+// 平方探测的查找要沿着探测序列一直走到空位，装填因子越高，最坏情况下要走得越远，尾延迟没有上界
+// 布谷鸟哈希让每个元素只有两个候选位置：桶 h1(x) 和桶 h2(x)，元素一定在这两个桶之一（或者在很小的 stash 里）
+//    - 查找：最多看两个桶，每个桶 4 个槽位，小元素的一个桶正好落在一个 cache line 里，最坏也只访问两个 cache line
+//    - 插入：两个桶都满了，就随机踢出其中一个元素（像布谷鸟把别的鸟蛋挤出巢），被踢出的元素去它的另一个候选桶，
+//      那里也满了就继续踢，直到找到空位
+//    - 删除：直接清掉槽位，不需要墓碑
+// 每个桶只放 1 个元素时，装填因子到 0.5 左右插入就会频繁失败；每个桶 4 路时，装填因子可以到 0.95 以上
+// 踢了 MAX_KICKS 次还没找到空位（踢出的元素形成了环），就把手上最后一个元素放进 stash
+// stash 是一个很小的数组，查找时最后看一眼（绝大多数时候是空的）。stash 也满了才扩容
+// 复杂度：查找、删除最坏 O(1)；插入均摊 O(1)
+
+// 两个哈希函数由同一个 64 位哈希值得到：先用 mixHash 把 std::hash 的结果搅匀，低 32 位给 h1，高 32 位给 h2
+
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+
+// --- 模板类 `CuckooHashTable` ---
+
+template<class HashedObj>
+class CuckooHashTable {
+public:
+    static constexpr int SLOTS_PER_BUCKET = 4;    // 每个桶的槽位数
+    static constexpr int STASH_CAPACITY = 8;      // stash 最多放多少个元素
+    static constexpr int MAX_KICKS = 500;         // 一次插入最多踢出多少次
+
+    // 构造函数：initialSize 是期望容纳的元素个数，桶数取 2 的幂
+    // maxLoadFactor 是触发扩容的装填因子，4 路布谷鸟哈希可以放到 0.95
+    explicit CuckooHashTable(int initialSize = 101, double maxLoadFactor = 0.95) : maxLoad(maxLoadFactor) {
+        int bucketCount = 1;
+        while (bucketCount * SLOTS_PER_BUCKET < initialSize) {
+            bucketCount <<= 1;
+        }
+        buckets.resize(bucketCount);
+        makeEmpty();
+    }
+
+    // 检查元素是否存在：只看两个桶和 stash
+    bool contains(const HashedObj &x) const {
+        size_t h1, h2;
+        bucketIndices(x, h1, h2);
+        return findInBucket(buckets[h1], x) != -1 || findInBucket(buckets[h2], x) != -1 || findInStash(x) != -1;
+    }
+
+    // 清空哈希表
+    void makeEmpty() {
+        for (auto &bucket : buckets) {
+            bucket.occupied = 0;
+        }
+        stash.clear();
+        currentSize = 0;
+    }
+
+    // 插入元素
+    bool insert(const HashedObj &x) {
+        if (contains(x)) {
+            return false;
+        }
+        if (currentSize + 1 > maxLoad * capacity()) {
+            rehash();
+        }
+        place(x);
+        currentSize++;
+        return true;
+    }
+
+    // 删除元素：直接清掉槽位，然后看看 stash 里的元素能不能搬回桶中
+    bool remove(const HashedObj &x) {
+        size_t h1, h2;
+        bucketIndices(x, h1, h2);
+        for (size_t b : {h1, h2}) {
+            int slot = findInBucket(buckets[b], x);
+            if (slot != -1) {
+                buckets[b].occupied &= ~(1u << slot);
+                buckets[b].items[slot] = HashedObj();    // 及时释放元素持有的资源
+                currentSize--;
+                drainStash();
+                return true;
+            }
+        }
+        int pos = findInStash(x);
+        if (pos == -1) {
+            return false;
+        }
+        stash[pos] = std::move(stash.back());
+        stash.pop_back();
+        currentSize--;
+        return true;
+    }
+
+    // 获取当前元素的数量
+    int size() const {
+        return currentSize;
+    }
+
+    // 获取哈希表的总槽位数（不含 stash）
+    int capacity() const {
+        return static_cast<int>(buckets.size()) * SLOTS_PER_BUCKET;
+    }
+
+    // 装填因子
+    double loadFactor() const {
+        return static_cast<double>(currentSize) / capacity();
+    }
+
+    // stash 中的元素个数
+    int stashSize() const {
+        return static_cast<int>(stash.size());
+    }
+
+    // 扩容次数，仅用于统计
+    int rehashCount() const {
+        return rehashes;
+    }
+
+    // 打印哈希表内容（用于调试）
+    void printHashTable() const {
+        std::cout << "--- Cuckoo Hash Table Contents (Size: " << currentSize << ", Capacity: " << capacity()
+                  << ", Stash: " << stash.size() << ") ---" << std::endl;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            std::cout << "Bucket " << i << ":";
+            for (int s = 0; s < SLOTS_PER_BUCKET; ++s) {
+                if (buckets[i].occupied & (1u << s)) {
+                    std::cout << " " << buckets[i].items[s];
+                } else {
+                    std::cout << " _";
+                }
+            }
+            std::cout << std::endl;
+        }
+        if (!stash.empty()) {
+            std::cout << "Stash:";
+            for (const auto &item : stash) {
+                std::cout << " " << item;
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "---------------------------------------------------" << std::endl;
+    }
+
+private:
+    // 桶按 16/32/64 字节对齐，桶不超过 64 字节时不会跨 cache line（例如 int：4 * 4 + 1 = 17 字节，按 32 字节对齐）
+    static constexpr size_t RAW_BUCKET_SIZE = sizeof(HashedObj) * SLOTS_PER_BUCKET + 1;
+    static constexpr size_t BUCKET_ALIGN = RAW_BUCKET_SIZE <= 16 ? 16 : (RAW_BUCKET_SIZE <= 32 ? 32 : 64);
+
+    struct alignas(BUCKET_ALIGN) Bucket {
+        HashedObj items[SLOTS_PER_BUCKET];
+        unsigned char occupied = 0;    // 第 s 位为 1 表示 items[s] 有元素
+    };
+
+    std::vector<Bucket> buckets;       // 桶数组，长度为 2 的幂
+    std::vector<HashedObj> stash;      // 插入失败的元素暂存在这里
+    int currentSize;                   // 元素数量（包括 stash 中的）
+    double maxLoad;                    // 触发扩容的装填因子
+    int rehashes = 0;                  // 扩容次数
+    unsigned randomState = 2463534242u;    // 选择踢出哪个槽位用的伪随机数（xorshift32）
+
+    // 两个候选桶的下标
+    void bucketIndices(const HashedObj &x, size_t &h1, size_t &h2) const {
+        uint64_t h = mixHash(static_cast<uint64_t>(DefaultHash<HashedObj>{}(x)));
+        size_t mask = buckets.size() - 1;
+        h1 = static_cast<size_t>(h) & mask;
+        h2 = static_cast<size_t>(h >> 32) & mask;
+    }
+
+    // 元素 x 的另一个候选桶
+    size_t alternateBucket(const HashedObj &x, size_t current) const {
+        size_t h1, h2;
+        bucketIndices(x, h1, h2);
+        return current == h1 ? h2 : h1;
+    }
+
+    // 在桶中查找 x，返回槽位下标，找不到返回 -1
+    int findInBucket(const Bucket &bucket, const HashedObj &x) const {
+        for (int s = 0; s < SLOTS_PER_BUCKET; ++s) {
+            if ((bucket.occupied & (1u << s)) && bucket.items[s] == x) {
+                return s;
+            }
+        }
+        return -1;
+    }
+
+    int findInStash(const HashedObj &x) const {
+        for (size_t i = 0; i < stash.size(); ++i) {
+            if (stash[i] == x) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // 如果桶里有空槽位，把 x 放进去
+    bool tryPut(Bucket &bucket, HashedObj &x) {
+        for (int s = 0; s < SLOTS_PER_BUCKET; ++s) {
+            if (!(bucket.occupied & (1u << s))) {
+                bucket.items[s] = std::move(x);
+                bucket.occupied |= 1u << s;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 安置一个确定不在表中的元素（不修改 currentSize）
+    void place(HashedObj x) {
+        size_t h1, h2;
+        bucketIndices(x, h1, h2);
+        if (tryPut(buckets[h1], x) || tryPut(buckets[h2], x)) {
+            return;
+        }
+
+        // 两个桶都满了：从 h1 开始，随机踢出一个元素，让它去自己的另一个候选桶
+        size_t current = h1;
+        for (int kick = 0; kick < MAX_KICKS; ++kick) {
+            randomState ^= randomState << 13;
+            randomState ^= randomState >> 17;
+            randomState ^= randomState << 5;
+            int victim = static_cast<int>(randomState % SLOTS_PER_BUCKET);
+            std::swap(x, buckets[current].items[victim]);
+            current = alternateBucket(x, current);
+            if (tryPut(buckets[current], x)) {
+                return;
+            }
+        }
+
+        // 踢了太多次，把手上的元素放进 stash；stash 也满了，就扩容后重新安置
+        if (stash.size() < STASH_CAPACITY) {
+            stash.push_back(std::move(x));
+            return;
+        }
+        rehash();
+        place(std::move(x));
+    }
+
+    // 删除之后桶里可能有了空位，把 stash 中能放回桶里的元素放回去
+    void drainStash() {
+        for (size_t i = 0; i < stash.size();) {
+            size_t h1, h2;
+            bucketIndices(stash[i], h1, h2);
+            if (tryPut(buckets[h1], stash[i]) || tryPut(buckets[h2], stash[i])) {
+                stash[i] = std::move(stash.back());
+                stash.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    // 再散列函数：桶数翻倍，所有元素（包括 stash 中的）重新安置
+    void rehash() {
+        std::vector<Bucket> oldBuckets = std::move(buckets);
+        std::vector<HashedObj> oldStash = std::move(stash);
+        buckets.assign(oldBuckets.size() * 2, Bucket());
+        stash.clear();
+        rehashes++;
+        for (auto &bucket : oldBuckets) {
+            for (int s = 0; s < SLOTS_PER_BUCKET; ++s) {
+                if (bucket.occupied & (1u << s)) {
+                    place(std::move(bucket.items[s]));
+                }
+            }
+        }
+        for (auto &item : oldStash) {
+            place(std::move(item));
+        }
+    }
+};
+
+// --- 查找延迟对比 ---
+
+// 对一张表逐个计时 queries 中的每次查找，打印 p50/p99/p99.9/max
+// 单次查找只有几十纳秒，计时本身的开销（调用 steady_clock::now）也算在里面，只适合在同一台机器上横向比较
+template<class Table>
+void measureLookupLatency(const char *name, const Table &table, double load, const std::vector<int> &queries) {
+    std::vector<long long> latencies(queries.size());
+    int found = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        found += table.contains(queries[i]);
+        auto end = std::chrono::steady_clock::now();
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    size_t n = latencies.size();
+    std::cout << "  " << name << " load " << load << ": p50=" << latencies[n / 2] << "ns p99=" << latencies[n / 100 * 99]
+              << "ns p99.9=" << latencies[n / 1000 * 999] << "ns max=" << latencies[n - 1] << "ns (found " << found << ")" << std::endl;
+}
+
+// --- 主函数测试 ---
+
+int main() {
+    // 1. 基本功能
+    std::cout << "--- Testing CuckooHashTable with int ---" << std::endl;
+    CuckooHashTable<int> intHashTable(8);
+    for (int x : {10, 21, 32, 13, 44, 55, 6, 17}) {
+        intHashTable.insert(x);
+    }
+    intHashTable.printHashTable();
+    std::cout << "Contains 21: " << (intHashTable.contains(21) ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 99: " << (intHashTable.contains(99) ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 13: " << (intHashTable.remove(13) ? "OK" : "Not found") << std::endl;
+    std::cout << "Contains 13: " << (intHashTable.contains(13) ? "Yes" : "No") << std::endl;
+
+    std::cout << "\n--- Testing CuckooHashTable with string ---" << std::endl;
+    CuckooHashTable<std::string> stringHashTable(4);
+    for (const char *s : {"apple", "banana", "cherry", "date", "elderberry", "fig"}) {
+        stringHashTable.insert(s);
+    }
+    stringHashTable.remove("cherry");
+    std::cout << "Contains 'banana': " << (stringHashTable.contains("banana") ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 'cherry': " << (stringHashTable.contains("cherry") ? "Yes" : "No") << std::endl;
+    std::cout << "Size: " << stringHashTable.size() << ", capacity: " << stringHashTable.capacity() << std::endl;
+
+    // 2. 填到 0.95 再反复插入删除，检查内容
+    std::cout << "\n--- Churn test at 95% load ---" << std::endl;
+    CuckooHashTable<int> churnTable(4096);
+    const int CHURN_SIZE = static_cast<int>(0.95 * churnTable.capacity()) - 1;
+    for (int i = 0; i < CHURN_SIZE; ++i) {
+        churnTable.insert(i);
+    }
+    for (int i = 0; i < 4 * CHURN_SIZE; ++i) {
+        churnTable.remove(i);
+        churnTable.insert(i + CHURN_SIZE);
+    }
+    bool churnOk = churnTable.size() == CHURN_SIZE && !churnTable.contains(4 * CHURN_SIZE - 1);
+    for (int i = 4 * CHURN_SIZE; i < 5 * CHURN_SIZE; ++i) {
+        churnOk &= churnTable.contains(i);
+    }
+    std::cout << "load=" << churnTable.loadFactor() << " stash=" << churnTable.stashSize() << " rehash=" << churnTable.rehashCount()
+              << ", contents check: " << (churnOk ? "OK" : "FAILED") << std::endl;
+
+    // 3. 查找延迟：布谷鸟哈希在 50% / 80% / 95% 装填因子下 vs 平方探测
+    // 平方探测的表自己会在占用超过一半时扩容，装填因子不会超过 0.5，所以它只在自己能达到的装填因子下测一次
+    // 查询一半命中、一半不命中（key 的最低位都是 0，key | 1 一定不在表中）
+    std::cout << "\n--- Lookup latency: cuckoo vs quadratic probing ---" << std::endl;
+    const int BUCKETS = 1 << 18;
+    const int QUERIES = 1 << 20;
+    unsigned seed = 2024;
+    std::vector<int> keys(BUCKETS * CuckooHashTable<int>::SLOTS_PER_BUCKET);
+    for (auto &k : keys) {
+        seed = seed * 1664525u + 1013904223u;
+        k = static_cast<int>(seed & 0x7ffffffe);
+    }
+    for (double load : {0.5, 0.8, 0.95}) {
+        CuckooHashTable<int> cuckoo(BUCKETS * CuckooHashTable<int>::SLOTS_PER_BUCKET);
+        int count = static_cast<int>(load * cuckoo.capacity()) - 1;
+        for (int i = 0; i < count; ++i) {
+            cuckoo.insert(keys[i]);
+        }
+        std::vector<int> queries(QUERIES);
+        for (int i = 0; i < QUERIES; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            queries[i] = keys[(seed >> 8) % count] | (i & 1);
+        }
+        measureLookupLatency("Cuckoo   ", cuckoo, cuckoo.loadFactor(), queries);
+        if (load == 0.5) {
+            HashTable<int> quadratic;
+            for (int i = 0; i < count; ++i) {
+                quadratic.insert(keys[i]);
+            }
+            measureLookupLatency("Quadratic", quadratic, quadratic.probeStats().loadFactor, queries);
+        }
+        std::cout << "    (cuckoo stash=" << cuckoo.stashSize() << ", rehash=" << cuckoo.rehashCount() << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,581 @@
+// 可扩展哈希（Extendible Hashing）：存放在磁盘文件中的哈希表，扩容时每次只分裂一个桶
+
+// SepChaining.cpp 的 rehash 一次把所有元素搬到新的桶数组里（渐进式 rehash 也只是把搬运分摊开，总量不变）
+// 表放在内存里时这没问题；但表存在一个比内存大得多的文件里时，一次全局 rehash 就是把整个文件读一遍、写一遍
+// 可扩展哈希把表分成两部分：
+//    1. 目录（directory）：2^globalDepth 个指针，用哈希值的低 globalDepth 位作为下标，指向某个桶
+//    2. 桶（bucket）：一个固定大小的页（PAGE_SIZE 字节），每个桶有自己的局部深度 localDepth，
+//       桶里所有元素哈希值的低 localDepth 位都相同，于是有 2^(globalDepth - localDepth) 个目录项指向同一个桶
+// 插入时桶满了，只分裂这一个桶：
+//    1. localDepth < globalDepth：新申请一个桶，两个桶的 localDepth 都 + 1，按哈希值的第 localDepth 位把元素分到两个桶里，
+//       原来指向旧桶的目录项中，这一位为 1 的一半改为指向新桶
+//    2. localDepth == globalDepth：目录项不够区分了，先把目录翻倍（globalDepth + 1，新的一半是旧的一半的拷贝），再按 1 分裂
+// 分裂只读写两个页，和表的大小无关；目录翻倍只在内存中拷贝指针，不碰任何桶
+// 目录每个桶只占 4 字节，一个桶页能放几百个元素，所以目录比数据小两三个数量级，可以常驻内存；
+// 桶页则通过一个固定大小的缓冲池（BufferPool，LRU 淘汰）访问，表可以比内存大得多
+// 删除只从桶里删掉元素，不合并桶、不收缩目录（和大多数数据库的实现一样，空间留给之后的插入）
+
+// 文件格式（本机字节序）：
+//    数据文件：第 0 页是文件头（FileHeader），之后每一页是一个桶
+//    目录文件（数据文件名 + ".dir"）：目录的所有页号，flush 时整体写出
+// 析构时会自动 flush，但析构中的 I/O 错误会被忽略；要看到写失败（磁盘满等），需在析构前显式调用 flush()
+// 元素必须可平凡复制（trivially copyable），直接按字节存进页里
+
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+// --- 缓冲池 ---
+
+// 把文件按 PAGE_SIZE 分页，最多在内存中缓存 capacity 个页，满了按 LRU 淘汰，脏页淘汰前先写回文件
+// 正在使用的页被“钉住”（pin），不会被淘汰。PageHandle 在构造时钉住、析构时放开，调用者不需要手动配对
+class BufferPool {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    // I/O 统计：页的读写次数，用于观察每次操作的 I/O 代价
+    struct IoStats {
+        long long pageReads = 0;
+        long long pageWrites = 0;
+    };
+
+    // 钉住一个页的句柄，只能移动，不能拷贝
+    class PageHandle {
+    public:
+        PageHandle(BufferPool *pool, int frame) : pool(pool), frame(frame) {}
+
+        PageHandle(PageHandle &&rhs) noexcept : pool(rhs.pool), frame(rhs.frame) {
+            rhs.pool = nullptr;
+        }
+
+        PageHandle(const PageHandle &) = delete;
+        PageHandle &operator=(const PageHandle &) = delete;
+        PageHandle &operator=(PageHandle &&) = delete;
+
+        ~PageHandle() {
+            if (pool != nullptr) {
+                pool->frames[frame].pinCount--;
+            }
+        }
+
+        char *data() const {
+            return pool->frames[frame].page->bytes;
+        }
+
+        // 修改过页的内容之后调用，淘汰或 flush 时才会写回
+        void markDirty() const {
+            pool->frames[frame].dirty = true;
+        }
+
+    private:
+        BufferPool *pool;
+        int frame;
+    };
+
+    // 打开（或创建）文件，capacity 至少为 2：分裂时要同时钉住两个桶
+    BufferPool(const std::string &path, size_t capacity) : frames(std::max<size_t>(2, capacity)) {
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            // 文件不存在，先创建再以读写方式打开
+            std::ofstream(path, std::ios::binary);
+            file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        }
+        if (!file.is_open()) {
+            throw std::runtime_error("BufferPool: cannot open " + path);
+        }
+        file.seekg(0, std::ios::end);
+        pageCount = static_cast<uint32_t>(static_cast<size_t>(file.tellg()) / PAGE_SIZE);
+        for (Frame &f : frames) {
+            f.page = std::make_unique<Page>();
+        }
+    }
+
+    // 析构时尽量写回脏页；析构函数不能抛异常，写失败会被吞掉，需要知道 I/O 错误的调用者应先显式调用 flush
+    ~BufferPool() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    // 取出一个已有的页并钉住，不在缓存中时从文件读入
+    PageHandle fetch(uint32_t pageId) {
+        auto it = pageTable.find(pageId);
+        if (it != pageTable.end()) {
+            touch(it->second);
+            frames[it->second].pinCount++;
+            return PageHandle(this, it->second);
+        }
+        int frame = victim();
+        Frame &f = frames[frame];
+        file.seekg(static_cast<std::streamoff>(pageId) * PAGE_SIZE);
+        file.read(f.page->bytes, PAGE_SIZE);
+        if (!file) {
+            throw std::runtime_error("BufferPool: short read");
+        }
+        stats.pageReads++;
+        install(frame, pageId);
+        return PageHandle(this, frame);
+    }
+
+    // 在文件末尾新分配一个全 0 的页并钉住，页号通过 pageId 返回
+    // 新页只存在于缓存中，被淘汰或 flush 时才真正写到文件里
+    PageHandle allocate(uint32_t &pageId) {
+        pageId = pageCount++;
+        int frame = victim();
+        std::fill(frames[frame].page->bytes, frames[frame].page->bytes + PAGE_SIZE, 0);
+        install(frame, pageId);
+        frames[frame].dirty = true;
+        return PageHandle(this, frame);
+    }
+
+    // 把所有脏页写回文件
+    void flush() {
+        for (Frame &f : frames) {
+            if (f.dirty) {
+                writeBack(f);
+            }
+        }
+        file.flush();
+    }
+
+    // 文件中的页数（包括还没写回的新页）
+    uint32_t size() const {
+        return pageCount;
+    }
+
+    IoStats ioStats() const {
+        return stats;
+    }
+
+private:
+    // 页对齐到 cache line，页里的元素可以直接按 HashedObj 访问
+    struct alignas(64) Page {
+        char bytes[PAGE_SIZE];
+    };
+
+    struct Frame {
+        std::unique_ptr<Page> page;
+        uint32_t pageId = 0;
+        bool used = false;     // 是否装着某个页
+        bool dirty = false;
+        int pinCount = 0;
+        std::list<int>::iterator lruPos;
+    };
+
+    std::fstream file;
+    std::vector<Frame> frames;
+    std::unordered_map<uint32_t, int> pageTable;    // 页号 -> 帧下标
+    std::list<int> lru;                             // 装着页的帧，表头是最近使用的
+    uint32_t pageCount = 0;
+    IoStats stats;
+
+    // 找一个空闲的帧；没有的话从 LRU 表尾往前找第一个没被钉住的帧，写回后腾出来
+    int victim() {
+        for (int i = 0; i < static_cast<int>(frames.size()); ++i) {
+            if (!frames[i].used) {
+                return i;
+            }
+        }
+        for (auto it = lru.rbegin(); it != lru.rend(); ++it) {
+            Frame &f = frames[*it];
+            if (f.pinCount == 0) {
+                if (f.dirty) {
+                    writeBack(f);
+                }
+                pageTable.erase(f.pageId);
+                lru.erase(f.lruPos);
+                f.used = false;
+                return static_cast<int>(&f - frames.data());
+            }
+        }
+        throw std::runtime_error("BufferPool: all pages are pinned");
+    }
+
+    // 帧 frame 装入页 pageId，放到 LRU 表头并钉住
+    void install(int frame, uint32_t pageId) {
+        Frame &f = frames[frame];
+        f.pageId = pageId;
+        f.used = true;
+        f.dirty = false;
+        f.pinCount = 1;
+        lru.push_front(frame);
+        f.lruPos = lru.begin();
+        pageTable[pageId] = frame;
+    }
+
+    // 最近使用过，移到 LRU 表头
+    void touch(int frame) {
+        lru.splice(lru.begin(), lru, frames[frame].lruPos);
+    }
+
+    void writeBack(Frame &f) {
+        file.seekp(static_cast<std::streamoff>(f.pageId) * PAGE_SIZE);
+        file.write(f.page->bytes, PAGE_SIZE);
+        if (!file) {
+            throw std::runtime_error("BufferPool: write failed");
+        }
+        f.dirty = false;
+        stats.pageWrites++;
+    }
+};
+
+// --- 模板类 `ExtendibleHashTable` ---
+
+template<class HashedObj, class Hash = DefaultHash<HashedObj>>
+class ExtendibleHashTable {
+    static_assert(std::is_trivially_copyable<HashedObj>::value, "ExtendibleHashTable stores elements as raw bytes");
+
+public:
+    using IoStats = BufferPool::IoStats;
+
+    // 打开 path 处的表，文件不存在（或为空）时新建一张空表，文件不是这种格式时抛出 runtime_error
+    // cachePages 是缓冲池的页数，决定了最多占用多少内存（cachePages * PAGE_SIZE 字节，外加目录）
+    explicit ExtendibleHashTable(const std::string &path, size_t cachePages = 64)
+        : pool(path, cachePages), directoryPath(path + ".dir") {
+        if (!load()) {
+            create();
+        }
+    }
+
+    // 析构时把所有修改写回文件；析构函数不能抛异常，写失败会被吞掉，需要知道 I/O 错误的调用者应先显式调用 flush
+    ~ExtendibleHashTable() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    ExtendibleHashTable(const ExtendibleHashTable &) = delete;
+    ExtendibleHashTable &operator=(const ExtendibleHashTable &) = delete;
+
+    // 检查元素是否存在：读一个页
+    bool contains(const HashedObj &x) {
+        BufferPool::PageHandle page = pool.fetch(directory[dirIndex(hashOf(x))]);
+        return findInBucket(page.data(), x) != -1;
+    }
+
+    // 插入元素，已存在时返回 false
+    // 桶满时分裂这个桶（必要时先把目录翻倍），分裂后元素可能全部落在同一边，所以要循环到放得下为止
+    bool insert(const HashedObj &x) {
+        uint64_t h = hashOf(x);
+        while (true) {
+            uint32_t pageId = directory[dirIndex(h)];
+            BufferPool::PageHandle page = pool.fetch(pageId);
+            BucketHeader *header = headerOf(page.data());
+            if (findInBucket(page.data(), x) != -1) {
+                return false;
+            }
+            if (header->count < BUCKET_CAPACITY) {
+                std::memcpy(&recordsOf(page.data())[header->count], &x, sizeof(HashedObj));
+                header->count++;
+                page.markDirty();
+                elementCount++;
+                return true;
+            }
+            if (header->localDepth == globalDepth) {
+                if (globalDepth == MAX_GLOBAL_DEPTH) {
+                    throw std::runtime_error("ExtendibleHashTable: too many elements with the same hash value");
+                }
+                doubleDirectory();
+            }
+            split(page, pageId);
+        }
+    }
+
+    // 删除元素：把桶里最后一个元素挪到被删的位置，只写一个页
+    bool remove(const HashedObj &x) {
+        BufferPool::PageHandle page = pool.fetch(directory[dirIndex(hashOf(x))]);
+        int pos = findInBucket(page.data(), x);
+        if (pos == -1) {
+            return false;
+        }
+        BucketHeader *header = headerOf(page.data());
+        HashedObj *records = recordsOf(page.data());
+        header->count--;
+        if (static_cast<uint32_t>(pos) != header->count) {    // 删的就是最后一个时不用挪，也避免自己拷贝到自己
+            std::memcpy(&records[pos], &records[header->count], sizeof(HashedObj));
+        }
+        page.markDirty();
+        elementCount--;
+        return true;
+    }
+
+    // 把缓冲池里的脏页、文件头和目录写回文件
+    void flush() {
+        {
+            BufferPool::PageHandle page = pool.fetch(0);
+            FileHeader *header = reinterpret_cast<FileHeader *>(page.data());
+            header->globalDepth = globalDepth;
+            header->elementCount = elementCount;
+            page.markDirty();
+        }
+        pool.flush();
+        std::ofstream out(directoryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(directory.data()), directory.size() * sizeof(uint32_t));
+        if (!out.flush()) {
+            throw std::runtime_error("ExtendibleHashTable: cannot write " + directoryPath);
+        }
+    }
+
+    // 获取元素数量
+    int size() const {
+        return static_cast<int>(elementCount);
+    }
+
+    // 获取桶（页）的数量，不含文件头
+    int bucketCount() const {
+        return static_cast<int>(pool.size()) - 1;
+    }
+
+    // 全局深度，目录项个数为 2^globalDepth
+    int depth() const {
+        return static_cast<int>(globalDepth);
+    }
+
+    // 目录占用的内存（字节）
+    size_t directoryMemory() const {
+        return directory.capacity() * sizeof(uint32_t);
+    }
+
+    // 每个桶页能放的元素个数
+    static constexpr int bucketCapacity() {
+        return BUCKET_CAPACITY;
+    }
+
+    IoStats ioStats() const {
+        return pool.ioStats();
+    }
+
+private:
+    // 桶页的页头，后面紧跟着元素数组
+    struct BucketHeader {
+        uint32_t localDepth;
+        uint32_t count;
+    };
+
+    // 数据文件第 0 页的文件头
+    struct FileHeader {
+        char magic[8];
+        uint32_t elementSize;
+        uint32_t globalDepth;
+        uint64_t elementCount;
+    };
+
+    static constexpr char MAGIC[8] = {'E', 'X', 'T', 'H', 'A', 'S', 'H', '1'};
+    static constexpr size_t RECORDS_OFFSET = (sizeof(BucketHeader) + alignof(HashedObj) - 1) / alignof(HashedObj) * alignof(HashedObj);
+    static constexpr uint32_t BUCKET_CAPACITY = (BufferPool::PAGE_SIZE - RECORDS_OFFSET) / sizeof(HashedObj);
+    static constexpr uint32_t MAX_GLOBAL_DEPTH = 30;    // 目录最多 2^30 项（4 GB），再大说明哈希值大量重复
+
+    static_assert(BUCKET_CAPACITY >= 2, "element type is too large for a bucket page");
+
+    BufferPool pool;
+    std::string directoryPath;
+    std::vector<uint32_t> directory;    // 目录：下标是哈希值的低 globalDepth 位，值是桶的页号
+    uint32_t globalDepth = 0;
+    uint64_t elementCount = 0;
+
+    static BucketHeader *headerOf(char *page) {
+        return reinterpret_cast<BucketHeader *>(page);
+    }
+
+    static HashedObj *recordsOf(char *page) {
+        return reinterpret_cast<HashedObj *>(page + RECORDS_OFFSET);
+    }
+
+    // 64 位哈希值，经过 mixHash 保证低位足够均匀（目录下标只用低位）
+    static uint64_t hashOf(const HashedObj &x) {
+        return mixHash(static_cast<uint64_t>(Hash{}(x)));
+    }
+
+    size_t dirIndex(uint64_t h) const {
+        return static_cast<size_t>(h & ((uint64_t(1) << globalDepth) - 1));
+    }
+
+    // 在桶页中顺序查找 x，返回下标，不存在时返回 -1
+    static int findInBucket(char *page, const HashedObj &x) {
+        const BucketHeader *header = headerOf(page);
+        const HashedObj *records = recordsOf(page);
+        for (uint32_t i = 0; i < header->count; ++i) {
+            if (records[i] == x) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // 目录翻倍：新的一半是旧的一半的拷贝，每个桶被指向的次数翻倍，桶本身不动
+    void doubleDirectory() {
+        size_t oldSize = directory.size();
+        directory.resize(2 * oldSize);
+        std::copy(directory.begin(), directory.begin() + oldSize, directory.begin() + oldSize);
+        globalDepth++;
+    }
+
+    // 分裂桶 page（页号 pageId，调用前保证 localDepth < globalDepth）：
+    // 哈希值第 localDepth 位为 1 的元素搬到新桶，目录中对应的一半指向新桶
+    void split(BufferPool::PageHandle &page, uint32_t pageId) {
+        BucketHeader *header = headerOf(page.data());
+        HashedObj *records = recordsOf(page.data());
+        uint32_t depth = header->localDepth;
+        uint64_t bit = uint64_t(1) << depth;
+
+        uint32_t newPageId;
+        BufferPool::PageHandle newPage = pool.allocate(newPageId);
+        BucketHeader *newHeader = headerOf(newPage.data());
+        HashedObj *newRecords = recordsOf(newPage.data());
+        newHeader->localDepth = depth + 1;
+        newHeader->count = 0;
+
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < header->count; ++i) {
+            if (hashOf(records[i]) & bit) {
+                std::memcpy(&newRecords[newHeader->count++], &records[i], sizeof(HashedObj));
+            } else {
+                std::memcpy(&records[kept++], &records[i], sizeof(HashedObj));
+            }
+        }
+        header->count = kept;
+        header->localDepth = depth + 1;
+        page.markDirty();
+        newPage.markDirty();
+
+        // 指向旧桶的目录项，低 depth 位都相同；其中第 depth 位为 1 的改为指向新桶
+        for (size_t i = 0; i < directory.size(); ++i) {
+            if (directory[i] == pageId && (i & bit)) {
+                directory[i] = newPageId;
+            }
+        }
+    }
+
+    // 新建一张空表：文件头 + 一个 localDepth 为 0 的桶，目录只有一项
+    void create() {
+        if (pool.size() != 0) {
+            throw std::runtime_error("ExtendibleHashTable: file exists but is not a valid table");
+        }
+        uint32_t headerPage, firstBucket;
+        {
+            BufferPool::PageHandle header = pool.allocate(headerPage);
+            FileHeader *fileHeader = reinterpret_cast<FileHeader *>(header.data());
+            std::memcpy(fileHeader->magic, MAGIC, sizeof(MAGIC));
+            fileHeader->elementSize = sizeof(HashedObj);
+        }
+        pool.allocate(firstBucket);    // 全 0 的页就是 localDepth 为 0 的空桶
+        directory.assign(1, firstBucket);
+        globalDepth = 0;
+        elementCount = 0;
+    }
+
+    // 打开已有的表：核对文件头，读入目录。文件是空的时返回 false
+    bool load() {
+        if (pool.size() == 0) {
+            return false;
+        }
+        BufferPool::PageHandle page = pool.fetch(0);
+        const FileHeader *header = reinterpret_cast<const FileHeader *>(page.data());
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->elementSize != sizeof(HashedObj)) {
+            throw std::runtime_error("ExtendibleHashTable: file is not a table of this element type");
+        }
+        globalDepth = header->globalDepth;
+        elementCount = header->elementCount;
+        directory.resize(size_t(1) << globalDepth);
+        std::ifstream in(directoryPath, std::ios::binary);
+        if (!in.read(reinterpret_cast<char *>(directory.data()), directory.size() * sizeof(uint32_t))) {
+            throw std::runtime_error("ExtendibleHashTable: cannot read " + directoryPath);
+        }
+        return true;
+    }
+};
+
+// --- 主函数测试 ---
+
+int main() {
+    const std::string path = "extendible_hash.dat";
+    std::remove(path.c_str());
+    std::remove((path + ".dir").c_str());
+
+    // 1. 基本功能
+    std::cout << "--- Testing ExtendibleHashTable<int> ---" << std::endl;
+    {
+        ExtendibleHashTable<int> table(path, 8);
+        for (int x : {10, 20, 30, 20}) {
+            std::cout << "Insert " << x << ": " << (table.insert(x) ? "OK" : "exists") << std::endl;
+        }
+        std::cout << "Contains 20: " << (table.contains(20) ? "Yes" : "No") << ", contains 25: " << (table.contains(25) ? "Yes" : "No")
+                  << std::endl;
+        std::cout << "Remove 20: " << (table.remove(20) ? "OK" : "Not found") << ", contains 20: " << (table.contains(20) ? "Yes" : "No")
+                  << std::endl;
+        std::cout << "Size: " << table.size() << ", buckets: " << table.bucketCount() << ", records per bucket page: "
+                  << ExtendibleHashTable<int>::bucketCapacity() << std::endl;
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".dir").c_str());
+
+    // 2. 表远大于缓冲池：每次插入的 I/O 都是常数个页，不会出现一次读写整张表的停顿
+    std::cout << "\n--- Growth with a 64-page (256 KB) buffer pool ---" << std::endl;
+    const int N = 1 << 20;
+    std::vector<int> keys(N);
+    for (int i = 0; i < N; ++i) {
+        // 乘以奇数在模 2^30 下是一一映射，所以 key 互不相同，而且都是偶数
+        keys[i] = static_cast<int>(2 * ((static_cast<unsigned>(i) * 0x9e3779b1u) & 0x3fffffff));
+    }
+    {
+        ExtendibleHashTable<int> table(path, 64);
+        long long maxIo = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int k : keys) {
+            auto before = table.ioStats();
+            table.insert(k);
+            auto after = table.ioStats();
+            maxIo = std::max(maxIo, after.pageReads - before.pageReads + after.pageWrites - before.pageWrites);
+        }
+        auto inserted = std::chrono::steady_clock::now();
+        auto io = table.ioStats();
+        std::cout << "Inserted " << table.size() << " keys in " << std::chrono::duration<double, std::milli>(inserted - start).count()
+                  << " ms: " << table.bucketCount() << " buckets (" << table.bucketCount() * BufferPool::PAGE_SIZE / (1024 * 1024)
+                  << " MB on disk), global depth " << table.depth() << ", directory " << table.directoryMemory() / 1024 << " KB"
+                  << std::endl;
+        std::cout << "Page I/O: " << io.pageReads << " reads, " << io.pageWrites << " writes, at most " << maxIo
+                  << " page reads + writes in a single insert" << std::endl;
+
+        int found = 0;
+        for (int i = 0; i < N; ++i) {
+            found += table.contains(keys[i]);
+            found += table.contains(keys[i] | 1);    // key 都是偶数，奇数一定不在表中
+        }
+        std::cout << "Lookups: found " << found << " of " << N << " (" << (found == N ? "OK" : "FAILED") << ")" << std::endl;
+        for (int i = 0; i < N; i += 2) {
+            table.remove(keys[i]);
+        }
+        std::cout << "After removing half: size " << table.size() << std::endl;
+    }
+
+    // 3. 重新打开：只读文件头和目录，不需要重建
+    std::cout << "\n--- Reopen ---" << std::endl;
+    {
+        auto start = std::chrono::steady_clock::now();
+        ExtendibleHashTable<int> table(path, 64);
+        auto opened = std::chrono::steady_clock::now();
+        int found = 0;
+        for (int i = 0; i < N; ++i) {
+            found += table.contains(keys[i]);
+        }
+        bool ok = found == table.size();
+        for (int i = 0; i < N && ok; i += 2) {
+            ok = !table.contains(keys[i]) && table.contains(keys[i + 1]);
+        }
+        std::cout << "Opened in " << std::chrono::duration<double, std::milli>(opened - start).count() << " ms, size " << table.size()
+                  << ", found " << found << " (" << (ok ? "OK" : "FAILED") << ")" << std::endl;
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".dir").c_str());
+
+    return 0;
+}
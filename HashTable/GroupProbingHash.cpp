@@ -0,0 +1,419 @@
+// 开放寻址法——分组探测（控制字节 + SIMD）的哈希表实现
+
+// ProbingHash.cpp 中，每个槽位是 HashEntry{element, info}，元素和状态交错存放
+// 二次探测时每探一个位置，都要读一次槽位（很可能是一次 cache miss），并做一次完整的 key 比较
+// 对于 string 这类 key，比较本身就不便宜，而绝大多数比较的结果都是“不相等”
+
+// 这里把状态单独拿出来，做成一个 1 字节的控制字节数组 ctrl（SoA，结构体数组 → 数组结构体）
+// 控制字节的编码如下：
+//    EMPTY   = 0b10000000 (-128)  空槽位
+//    DELETED = 0b11111110 (-2)    已删除（墓碑）
+//    FULL    = 0b0xxxxxxx         活跃元素，低 7 位存放该元素哈希值的一个片段 h2
+// 三种状态中，只有 FULL 的最高位是 0，所以“是否空闲”只需要看符号位
+
+// 哈希值被拆成两部分：
+//    h1 = hash >> 7     决定从哪个组开始探测
+//    h2 = hash & 0x7F   存进控制字节，作为指纹
+// 表被划分为若干组，每组 16 个槽位。探测时一次取出一组的 16 个控制字节，
+// 用 SSE2 指令一次性和 h2 比较，得到一个 16 位的掩码，只有掩码中为 1 的槽位才需要真正比较 key
+// 由于指纹有 7 位，不相等的 key 指纹相同的概率只有 1/128，几乎所有无用的 key 比较都被过滤掉了
+
+// 查找的终止条件：
+// 如果一组里存在 EMPTY，说明当初插入时探测序列到这一组就停下了，目标不可能在更后面的组里
+// 所以查找失败时，也只需要看到第一个含有 EMPTY 的组就可以结束
+
+// 组间探测序列：g, g+1, g+3, g+6, ...（三角数）
+// 组数取 2 的幂时，三角数探测可以保证遍历到每一个组（这也是数论！！）
+// 取模也就变成了按位与，不再需要 nextPrime
+
+// 删除：
+// 如果被删除元素所在的组里本来就有 EMPTY，那么没有任何探测序列会“穿过”这一组，可以直接标记为 EMPTY
+// 否则只能打墓碑 DELETED，等到 rehash 时统一清理
+
+#include <cstdint>
+#include <functional>    // for std::hash
+#include <iostream>
+#include <string>
+#include <vector>
+
+// SSE2 是 x86-64 的基线指令集，所有 64 位 x86 编译器都会默认开启
+// 其他平台（例如 ARM）退化为逐字节比较的标量实现，语义完全相同
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GROUP_PROBING_USE_SSE2
+#endif
+
+// --- 全局辅助函数 ---
+
+// 辅助函数：返回二进制最低位 1 的下标（mask 不能为 0）
+inline int lowestBitIndex(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// 辅助函数：对 std::hash 的结果再做一次混合
+// libstdc++ 中 std::hash<int> 是恒等函数，连续的整数只在低位不同
+// 而 h1 取的是高位，不混合的话，0~127 会全部挤进同一个组
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// --- 控制字节组 ---
+
+// 一组 16 个控制字节的视图，负责“一次比较 16 个”的那部分工作
+// 所有 match 函数都返回一个 16 位掩码，第 i 位为 1 表示组内第 i 个槽位满足条件
+class Group {
+public:
+    static constexpr int WIDTH = 16;
+
+    explicit Group(const int8_t *pos) {
+#ifdef GROUP_PROBING_USE_SSE2
+        ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+#else
+        for (int i = 0; i < WIDTH; ++i) {
+            ctrl[i] = pos[i];
+        }
+#endif
+    }
+
+    // 控制字节等于 h2 的槽位（候选槽位，仍需比较 key）
+    uint32_t match(int8_t h2) const {
+#ifdef GROUP_PROBING_USE_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+#else
+        return matchByte(h2);
+#endif
+    }
+
+    // 状态为 EMPTY 的槽位
+    uint32_t matchEmpty() const {
+#ifdef GROUP_PROBING_USE_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(-128))));
+#else
+        return matchByte(-128);
+#endif
+    }
+
+    // 状态为 EMPTY 或 DELETED 的槽位，即可以放入新元素的槽位
+    // 二者的最高位都是 1，movemask 直接取出每个字节的符号位，连比较都省了
+    uint32_t matchEmptyOrDeleted() const {
+#ifdef GROUP_PROBING_USE_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < WIDTH; ++i) {
+            if (ctrl[i] < 0) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+private:
+#ifdef GROUP_PROBING_USE_SSE2
+    __m128i ctrl;
+#else
+    int8_t ctrl[WIDTH];
+
+    uint32_t matchByte(int8_t b) const {
+        uint32_t mask = 0;
+        for (int i = 0; i < WIDTH; ++i) {
+            if (ctrl[i] == b) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+#endif
+};
+
+// --- 模板类 `HashTable` ---
+
+template<class HashedObj>
+class HashTable {
+public:
+    // 构造函数：初始化哈希表
+    // 容量向上取整为 16 * 2^k，保证组数是 2 的幂
+    explicit HashTable(int initialSize = 101) {
+        allocate(groupsFor(initialSize));
+    }
+
+    // 检查元素是否存在
+    bool contains(const HashedObj &x) const {
+        return findPos(x) != -1;
+    }
+
+    // 清空哈希表
+    // 只需要把控制字节全部改回 EMPTY，槽位中的旧元素会在下次写入时被覆盖
+    void makeEmpty() {
+        for (auto &c : ctrl) {
+            c = EMPTY;
+        }
+        currentActiveSize = 0;
+        currentDeletedSize = 0;
+    }
+
+    // 插入元素
+    bool insert(const HashedObj &x) {
+        uint64_t hashVal = hashOf(x);
+        int8_t h2 = static_cast<int8_t>(hashVal & 0x7F);
+        size_t groupIndex = (hashVal >> 7) & groupMask;
+        int insertPos = -1;    // 探测过程中遇到的第一个空闲槽位（EMPTY 或 DELETED）
+
+        // 与 findPos 一样沿着探测序列走，但顺便记下第一个可以落脚的位置
+        // 不能一看到 DELETED 就插入：x 可能就在更后面的组里，必须先确认它不存在
+        for (size_t step = 0; step <= groupMask; ++step) {
+            Group group(&ctrl[groupIndex * Group::WIDTH]);
+
+            for (uint32_t mask = group.match(h2); mask != 0; mask &= mask - 1) {
+                int pos = static_cast<int>(groupIndex * Group::WIDTH) + lowestBitIndex(mask);
+                if (array[pos] == x) {
+                    return false;    // 元素已存在
+                }
+            }
+
+            uint32_t freeMask = group.matchEmptyOrDeleted();
+            if (insertPos == -1 && freeMask != 0) {
+                insertPos = static_cast<int>(groupIndex * Group::WIDTH) + lowestBitIndex(freeMask);
+            }
+            if (group.matchEmpty() != 0) {
+                break;    // 遇到含 EMPTY 的组，x 一定不在表中
+            }
+            groupIndex = (groupIndex + step + 1) & groupMask;
+        }
+
+        if (ctrl[insertPos] == DELETED) {
+            currentDeletedSize--;    // 复用了一个墓碑
+        }
+        ctrl[insertPos] = h2;
+        array[insertPos] = x;
+        currentActiveSize++;
+
+        // 分组探测在很高的负载下依然表现良好，这里把负载因子上限设为 7/8
+        // 墓碑同样会拉长探测序列，所以要和活跃元素一起计算
+        if (currentActiveSize + currentDeletedSize > capacity() / 8 * 7) {
+            rehash();
+        }
+        return true;
+    }
+
+    // 删除元素
+    bool remove(const HashedObj &x) {
+        int currentPos = findPos(x);
+        if (currentPos == -1) {
+            return false;
+        }
+
+        // 所在组里本来就有 EMPTY，说明没有探测序列会越过这一组，可以直接置为 EMPTY
+        Group group(&ctrl[currentPos / Group::WIDTH * Group::WIDTH]);
+        if (group.matchEmpty() != 0) {
+            ctrl[currentPos] = EMPTY;
+        } else {
+            ctrl[currentPos] = DELETED;
+            currentDeletedSize++;
+        }
+        currentActiveSize--;
+        return true;
+    }
+
+    // 获取当前活跃元素的数量
+    int size() const {
+        return currentActiveSize;
+    }
+
+    // 获取哈希表（槽位）的总容量
+    int capacity() const {
+        return static_cast<int>(ctrl.size());
+    }
+
+    // 打印哈希表内容（用于调试），每行一组
+    void printHashTable() const {
+        std::cout << "--- Hash Table Contents (Active: " << currentActiveSize << ", Capacity: " << capacity() << ") ---" << std::endl;
+        for (int g = 0; g * Group::WIDTH < capacity(); ++g) {
+            std::cout << "Group " << g << ": ";
+            for (int i = g * Group::WIDTH; i < (g + 1) * Group::WIDTH; ++i) {
+                if (ctrl[i] == EMPTY) {
+                    std::cout << "_ ";
+                } else if (ctrl[i] == DELETED) {
+                    std::cout << "X ";
+                } else {
+                    std::cout << array[i] << " ";
+                }
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "---------------------------------------------------" << std::endl;
+    }
+
+private:
+    static constexpr int8_t EMPTY = -128;    // 0b10000000
+    static constexpr int8_t DELETED = -2;    // 0b11111110
+
+    std::vector<int8_t> ctrl;       // 控制字节数组，与 array 一一对应
+    std::vector<HashedObj> array;   // 存放元素的槽位数组
+    size_t groupMask;               // 组数 - 1，组数是 2 的幂
+    int currentActiveSize;          // 当前活跃元素的数量
+    int currentDeletedSize;         // 当前墓碑的数量
+
+    // 计算容纳 n 个槽位所需的组数（向上取到 2 的幂）
+    static size_t groupsFor(int n) {
+        size_t groups = 1;
+        while (groups * Group::WIDTH < static_cast<size_t>(n)) {
+            groups <<= 1;
+        }
+        return groups;
+    }
+
+    // 按组数分配两个数组，并把所有控制字节置为 EMPTY
+    void allocate(size_t groups) {
+        ctrl.assign(groups * Group::WIDTH, EMPTY);
+        array.assign(groups * Group::WIDTH, HashedObj());
+        groupMask = groups - 1;
+        currentActiveSize = 0;
+        currentDeletedSize = 0;
+    }
+
+    // 查找元素 x 的位置，不存在时返回 -1
+    int findPos(const HashedObj &x) const {
+        uint64_t hashVal = hashOf(x);
+        int8_t h2 = static_cast<int8_t>(hashVal & 0x7F);
+        size_t groupIndex = (hashVal >> 7) & groupMask;
+
+        for (size_t step = 0; step <= groupMask; ++step) {
+            Group group(&ctrl[groupIndex * Group::WIDTH]);
+
+            // 只有指纹命中的槽位才会读取 array，做真正的 key 比较
+            for (uint32_t mask = group.match(h2); mask != 0; mask &= mask - 1) {
+                int pos = static_cast<int>(groupIndex * Group::WIDTH) + lowestBitIndex(mask);
+                if (array[pos] == x) {
+                    return pos;
+                }
+            }
+            if (group.matchEmpty() != 0) {
+                return -1;
+            }
+            groupIndex = (groupIndex + step + 1) & groupMask;
+        }
+        return -1;
+    }
+
+    // 再散列函数
+    // 墓碑较多时（活跃元素不足容量的 7/16），保持容量不变，只是借重建来清理墓碑
+    // 否则容量翻倍
+    void rehash() {
+        std::vector<int8_t> oldCtrl = std::move(ctrl);
+        std::vector<HashedObj> oldArray = std::move(array);
+
+        size_t groups = groupMask + 1;
+        if (currentActiveSize >= static_cast<int>(oldCtrl.size() / 16 * 7)) {
+            groups *= 2;
+        }
+        allocate(groups);
+
+        for (size_t i = 0; i < oldCtrl.size(); ++i) {
+            if (oldCtrl[i] >= 0) {    // FULL
+                insert(oldArray[i]);
+            }
+        }
+    }
+
+    // 核心哈希函数，返回混合后的 64 位哈希值，由调用者拆分为 h1 和 h2
+    uint64_t hashOf(const HashedObj &x) const {
+        return mixHash(static_cast<uint64_t>(std::hash<HashedObj>{}(x)));
+    }
+};
+
+// --- 主函数测试 ---
+
+int main() {
+    // 1. 测试 int 类型的哈希表
+    std::cout << "--- Testing HashTable with int (Group Probing) ---" << std::endl;
+    HashTable<int> intHashTable(16);    // 一组 16 个槽位
+
+    for (int x : {10, 21, 32, 13, 44, 55, 6, 17, 28}) {
+        intHashTable.insert(x);
+    }
+    intHashTable.printHashTable();
+
+    std::cout << "Contains 21: " << (intHashTable.contains(21) ? "Yes" : "No") << std::endl;    // 应该 Yes
+    std::cout << "Contains 99: " << (intHashTable.contains(99) ? "Yes" : "No") << std::endl;    // 应该 No
+
+    // 继续插入，超过 16 * 7/8 = 14 个元素后触发 rehash，组数翻倍
+    for (int x = 100; x < 110; ++x) {
+        intHashTable.insert(x);
+    }
+    std::cout << "\nAfter inserting 100..109 (should have rehashed):" << std::endl;
+    intHashTable.printHashTable();
+
+    std::cout << "\nRemoving 13..." << std::endl;
+    intHashTable.remove(13);
+    std::cout << "Contains 13: " << (intHashTable.contains(13) ? "Yes" : "No") << std::endl;    // 应该 No
+    std::cout << "Removing 100 (twice): " << intHashTable.remove(100) << " " << intHashTable.remove(100) << std::endl;
+    std::cout << "Size: " << intHashTable.size() << std::endl;
+
+    // 2. 大量插入、删除，与直接标记的结果对照，确认探测与墓碑逻辑正确
+    std::cout << "\n--- Insert/remove churn check ---" << std::endl;
+    HashTable<int> churnTable;
+    std::vector<bool> present(20000, false);
+    unsigned seed = 12345;
+    bool ok = true;
+    for (int round = 0; round < 200000; ++round) {
+        seed = seed * 1103515245 + 12345;
+        int key = static_cast<int>((seed >> 8) % present.size());
+        if ((seed >> 4) & 1) {
+            ok &= churnTable.insert(key) == !present[key];
+            present[key] = true;
+        } else {
+            ok &= churnTable.remove(key) == present[key];
+            present[key] = false;
+        }
+    }
+    int expectedSize = 0;
+    for (size_t k = 0; k < present.size(); ++k) {
+        ok &= churnTable.contains(static_cast<int>(k)) == present[k];
+        expectedSize += present[k];
+    }
+    ok &= churnTable.size() == expectedSize;
+    std::cout << "Size: " << churnTable.size() << ", Capacity: " << churnTable.capacity() << std::endl;
+    std::cout << "Churn check: " << (ok ? "OK" : "FAILED") << std::endl;
+
+    // 3. 测试 string 类型的哈希表
+    std::cout << "\n--- Testing HashTable with string ---" << std::endl;
+    HashTable<std::string> stringHashTable(5);
+
+    stringHashTable.insert("apple");
+    stringHashTable.insert("banana");
+    stringHashTable.insert("cherry");
+    stringHashTable.insert("date");
+    stringHashTable.insert("elderberry");
+    stringHashTable.insert("fig");
+
+    stringHashTable.printHashTable();
+
+    std::cout << "Contains 'banana': " << (stringHashTable.contains("banana") ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 'grape': " << (stringHashTable.contains("grape") ? "Yes" : "No") << std::endl;
+
+    std::cout << "Removing 'cherry'..." << std::endl;
+    stringHashTable.remove("cherry");
+    std::cout << "Contains 'cherry': " << (stringHashTable.contains("cherry") ? "Yes" : "No") << std::endl;
+
+    std::cout << "\nMake empty..." << std::endl;
+    stringHashTable.makeEmpty();
+    std::cout << "Size after makeEmpty: " << stringHashTable.size() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+// 哈希函数的质量与吞吐量对比：同一组 key 分别用不同的哈希函数放进平方探测表（ProbingHash.cpp）和分离链接表（SepChaining.cpp）
+
+// 两张表默认都用 DefaultHash，也就是 std::hash。libstdc++ 的 std::hash<整数> 是恒等函数：
+//    - 好处是快，几乎没有开销
+//    - 坏处是 key 的规律原样保留到下标上：表长为 2 的幂、直接取低位（位与）时，
+//      步长为 4096 的 key、只有高位不同的 key 会全部挤在少数几个位置上
+// 质数取模会把这种规律“打散”大部分，但依赖质数表长和一次除法。要不要换哈希函数，取决于 key 的分布
+// 这里比较四种哈希函数（定义在 HashFunctions.cpp，可以直接 #include 到别的文件里使用）：
+//    1. IdentityHash：恒等函数，等价于 libstdc++ 的 std::hash<整数>
+//    2. FibonacciHash：乘以 2^64 / 黄金分割比（Knuth 的乘法散列），一次乘法，高位质量好、低位差
+//       表长为 2 的幂时要配合取最高位的 FibonacciSizePolicy
+//    3. WyHash：wyhash 风格的 64x64->128 位乘法后把高低两半异或（mum），两次乘法，每一位都充分混合
+//    4. Crc32Hash：CRC32C，有 SSE4.2 时是一条硬件指令（编译时加 -msse4.2），否则查表计算
+// 每种组合报告：
+//    - 平方探测表的 ASL(success)、最长探测次数、ASL(failure)（见 ProbingHash.cpp 的 ProbeStats）
+//    - 分离链接表的桶长度直方图（HashTable::bucketLengthHistogram）：均匀的哈希函数在装填因子 1 附近接近泊松分布
+//    - 两张表 insert 与 contains 的吞吐量（百万次操作每秒，Mops）
+// 容量策略分两组：
+//    1. PrimeSizePolicy：两张表的默认策略，质数取模
+//    2. MaskSizePolicy：表长为 2 的幂、下标直接取哈希值的低位，不做任何混合
+//       这是“哈希函数本身有多好”的试金石；PowerOfTwoSizePolicy 会先用 mixHash 混合一次，掩盖了哈希函数的差异
+//       FibonacciHash 例外：这一组里它配合 FibonacciSizePolicy 取最高位，否则就不是 Fibonacci hashing 了
+// 结论（以本机一次运行的结果为准，换了机器或 key 的分布应该重新跑一遍）：
+//    1. 质数取模下，恒等函数的成功查找最快，但连续的 key 占满了表中一整段连续的位置，
+//       不命中的查找要在这一段里探测很久（ASL(failure) 上百）；FibonacciHash 只多一次乘法，就消除了这个问题
+//    2. 直接取低位时，恒等函数遇到 STRIDED、HIGH_BITS 退化为一条链；FibonacciHash 取最高位后，在这些有规律的 key 上
+//       比随机还均匀（几乎每个桶一个元素），只有 CLUSTERED 稍差；wyhash 在所有分布上都接近随机，但要多一次乘法
+//    3. 没有 SSE4.2 时 CRC32 查表太慢；有硬件指令时和 wyhash 相当，但它是线性的，规律的 key 仍然会得到有规律的下标
+
+// 两个文件里有同名的全局定义（HashTable、DefaultHash、各种 SizePolicy……），不能直接放进同一个翻译单元
+// 所以各自包进一个命名空间：probing 和 chaining
+// 标准库和系统头文件必须先在全局包含，命名空间里的 #include 遇到 include guard 就什么都不做，不会把标准库声明进命名空间
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace probing {
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+}    // namespace probing
+
+namespace chaining {
+#define SEP_CHAINING_NO_MAIN
+#include "SepChaining.cpp"
+}    // namespace chaining
+
+#define HASH_FUNCTIONS_NO_MAIN
+#include "HashFunctions.cpp"    // IdentityHash、FibonacciHash、WyHash、Crc32Hash，以及 MaskSizePolicy、FibonacciSizePolicy
+
+// --- key 的分布 ---
+
+enum class KeyDistribution {
+    SEQUENTIAL,    // 0, 1, 2, ...：自增 ID
+    STRIDED,       // 0, 4096, 8192, ...：按页对齐的地址、按固定步长分配的 ID
+    HIGH_BITS,     // i << 32：只有高 32 位不同，例如 (分片号, 0) 这样拼出来的 key
+    CLUSTERED,     // 每 1024 个连续的 key 为一段，段与段之间相距很远：按时间分段的时间戳
+    RANDOM         // 均匀随机的 64 位整数
+};
+
+const char *distributionName(KeyDistribution dist) {
+    switch (dist) {
+        case KeyDistribution::SEQUENTIAL:
+            return "sequential";
+        case KeyDistribution::STRIDED:
+            return "strided";
+        case KeyDistribution::HIGH_BITS:
+            return "high bits";
+        case KeyDistribution::CLUSTERED:
+            return "clustered";
+        default:
+            return "random";
+    }
+}
+
+// 第 i 个 key，同一个 i 总是得到同一个 key，不同的 i 得到不同的 key
+uint64_t makeKey(KeyDistribution dist, uint64_t i) {
+    switch (dist) {
+        case KeyDistribution::SEQUENTIAL:
+            return i;
+        case KeyDistribution::STRIDED:
+            return i * 4096;
+        case KeyDistribution::HIGH_BITS:
+            return i << 32;
+        case KeyDistribution::CLUSTERED:
+            return (i >> 10) * 1000003 * 4096 + (i & 1023);
+        default:
+            return chaining::mixHash(i + 1);    // fmix64 是双射，不同的 i 一定得到不同的 key
+    }
+}
+
+// --- 对比 ---
+
+double mops(size_t ops, std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return ops / std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+// 用一种哈希函数和容量策略，对一种分布的 n 个 key 测两张表，打印一行结果
+// 查询一半是表中的 key，一半是同一分布中不在表里的 key（第 n ~ 2n - 1 个）
+template<class Hash, class ProbingPolicy, class ChainingPolicy>
+void benchmarkHash(const char *hashName, KeyDistribution dist, int n) {
+    std::vector<uint64_t> keys(n), queries(n);
+    for (int i = 0; i < n; ++i) {
+        keys[i] = makeKey(dist, i);
+        queries[i] = makeKey(dist, (i & 1) ? n + i : i);
+    }
+
+    probing::HashTable<uint64_t, ProbingPolicy, Hash> probingTable;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t k : keys) {
+        probingTable.insert(k);
+    }
+    auto probingInserted = std::chrono::steady_clock::now();
+    int probingFound = 0;
+    for (uint64_t q : queries) {
+        probingFound += probingTable.contains(q);
+    }
+    auto probingLooked = std::chrono::steady_clock::now();
+
+    chaining::HashTable<uint64_t, ChainingPolicy, Hash> chainingTable;
+    auto chainingStart = std::chrono::steady_clock::now();
+    for (uint64_t k : keys) {
+        chainingTable.insert(k);
+    }
+    auto chainingInserted = std::chrono::steady_clock::now();
+    int chainingFound = 0;
+    for (uint64_t q : queries) {
+        chainingFound += chainingTable.contains(q);
+    }
+    auto chainingLooked = std::chrono::steady_clock::now();
+
+    auto stats = probingTable.probeStats();
+    std::vector<int> histogram = chainingTable.bucketLengthHistogram();
+    // 直方图只打印 0、1、2、3 和 4 个以上所占的比例，以及最长的桶
+    double buckets = chainingTable.bucketCount();
+    double tail = 0;
+    for (size_t len = 4; len < histogram.size(); ++len) {
+        tail += histogram[len];
+    }
+    auto share = [&](size_t len) {
+        return 100.0 * (len < histogram.size() ? histogram[len] : 0) / buckets;
+    };
+
+    std::cout << "  " << std::left << std::setw(10) << distributionName(dist) << " " << std::setw(9) << hashName << std::right
+              << std::fixed << std::setprecision(2) << " | ASL " << stats.avgSuccessfulProbe << " / " << std::setw(6)
+              << stats.avgUnsuccessfulProbe << ", max " << std::setw(5) << stats.maxSuccessfulProbe << std::setprecision(0)
+              << " | buckets 0:" << share(0) << "% 1:" << share(1) << "% 2:" << share(2) << "% 3:" << share(3)
+              << "% 4+:" << 100.0 * tail / buckets << "%, max " << histogram.size() - 1 << std::setprecision(1)
+              << " | probing " << mops(n, start, probingInserted) << " / " << mops(n, probingInserted, probingLooked)
+              << " Mops, chaining " << mops(n, chainingStart, chainingInserted) << " / "
+              << mops(n, chainingInserted, chainingLooked) << " Mops" << std::defaultfloat << std::setprecision(6);
+    if (probingFound != n / 2 || chainingFound != n / 2) {
+        std::cout << " (found " << probingFound << " / " << chainingFound << ", expected " << n / 2 << ")";
+    }
+    std::cout << std::endl;
+}
+
+// FibonacciHash 的好位在高位，质数取模以外的组里要换成取高位的 FibonacciProbingPolicy / FibonacciChainingPolicy
+template<class ProbingPolicy, class ChainingPolicy, class FibonacciProbingPolicy = ProbingPolicy,
+         class FibonacciChainingPolicy = ChainingPolicy>
+void benchmarkAllHashes(int n) {
+    for (KeyDistribution dist : {KeyDistribution::SEQUENTIAL, KeyDistribution::STRIDED, KeyDistribution::HIGH_BITS,
+                                 KeyDistribution::CLUSTERED, KeyDistribution::RANDOM}) {
+        benchmarkHash<IdentityHash, ProbingPolicy, ChainingPolicy>("identity", dist, n);
+        benchmarkHash<FibonacciHash, FibonacciProbingPolicy, FibonacciChainingPolicy>("fibonacci", dist, n);
+        benchmarkHash<WyHash, ProbingPolicy, ChainingPolicy>("wyhash", dist, n);
+        benchmarkHash<Crc32Hash, ProbingPolicy, ChainingPolicy>("crc32", dist, n);
+    }
+}
+
+// --- 主函数测试 ---
+
+int main() {
+    std::cout << "Columns: ASL(success) / ASL(failure), max probes (quadratic probing) | bucket length histogram "
+                 "(separate chaining) | insert / contains throughput"
+              << std::endl;
+
+    // 1. 默认的质数取模
+    std::cout << "\n--- PrimeSizePolicy (hash % prime) ---" << std::endl;
+    benchmarkAllHashes<probing::PrimeSizePolicy, chaining::PrimeSizePolicy>(1 << 19);
+
+    // 2. 直接取低位：哈希函数的低位质量差时会严重聚集
+    // 恒等函数遇到 HIGH_BITS 时所有 key 落在同一个位置，平方探测退化为 O(n^2)，所以这一组用的 key 少一些
+    // FibonacciHash 这一行换成取最高位的 FibonacciSizePolicy，即真正的 Fibonacci hashing
+    std::cout << "\n--- MaskSizePolicy (hash & (size - 1), no mixing; fibonacci takes the top bits) ---" << std::endl;
+    benchmarkAllHashes<MaskSizePolicy, MaskSizePolicy, FibonacciSizePolicy, FibonacciSizePolicy>(1 << 14);
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+// 整数 key 的哈希函数和两种不做混合的容量策略，ProbingHash.cpp 和 SepChaining.cpp 的 HashTable 都可以直接使用：
+//    HashTable<uint64_t, PrimeSizePolicy, FibonacciHash>
+//    HashTable<uint64_t, FibonacciSizePolicy, FibonacciHash>
+//    HashTable<uint64_t, MaskSizePolicy, WyHash>
+// 各种组合的质量和吞吐量对比见 HashFunctionBench.cpp
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+// --- 哈希函数 ---
+
+// 都是无状态的函数对象，作为两张表的 Hash 模板参数使用
+// ID 和 ProbingHash.cpp 的 DefaultHash（ID = 1）互不相同，用于核对快照文件
+
+struct IdentityHash {
+    static constexpr uint32_t ID = 2;
+
+    size_t operator()(uint64_t x) const {
+        return static_cast<size_t>(x);
+    }
+};
+
+// 黄金分割比的乘法散列：乘积的高位由 x 的所有位决定，低位只由 x 的低位决定
+// 所以配合质数取模（用到了所有位）效果很好；表长为 2 的幂时必须取高位，也就是配合下面的 FibonacciSizePolicy，
+// 这才是 Knuth 的 Fibonacci hashing。配合取低位的 MaskSizePolicy 时和恒等函数一样差
+struct FibonacciHash {
+    static constexpr uint32_t ID = 3;
+
+    size_t operator()(uint64_t x) const {
+        return static_cast<size_t>(x * 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+// wyhash 对单个 64 位整数的哈希（wyhash64）：两次 64x64->128 位乘法，每次把乘积的高低两半异或
+struct WyHash {
+    static constexpr uint32_t ID = 4;
+
+    size_t operator()(uint64_t x) const {
+        return static_cast<size_t>(mum(mum(x ^ 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL) ^ 0xa0761d6478bd642fULL,
+                                       0xe7037ed1a0b428dbULL));
+    }
+
+private:
+    static uint64_t mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+        return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+        // 没有 128 位整数时，按 32 位拆开做 4 次乘法
+        uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t carry = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        carry += lo < t;
+        uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+        return lo ^ hi;
+#endif
+    }
+};
+
+// CRC32C（Castagnoli 多项式）。结果只有 32 位，对不超过 2^32 的表长足够了
+struct Crc32Hash {
+    static constexpr uint32_t ID = 5;
+
+    size_t operator()(uint64_t x) const {
+#if defined(__SSE4_2__)
+        return static_cast<size_t>(_mm_crc32_u64(0xffffffffu, x));
+#else
+        uint32_t crc = 0xffffffffu;
+        for (int i = 0; i < 8; ++i) {
+            crc = table()[(crc ^ (x >> (8 * i))) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+#endif
+    }
+
+private:
+#if !defined(__SSE4_2__)
+    // 按字节查表的 CRC32C，表在第一次使用时生成
+    static const uint32_t *table() {
+        static const std::vector<uint32_t> crcTable = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? (c >> 1) ^ 0x82f63b78u : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+        return crcTable.data();
+    }
+#endif
+};
+
+// --- 容量策略 ---
+
+// 表长为 2 的幂，下标直接取哈希值的低位，不混合（和两个文件里的 PowerOfTwoSizePolicy 唯一的区别）
+// 平方探测用三角数探测（PROBE_STEP = 1），同样能遍历所有位置
+// ID 接在 ProbingHash.cpp 的三个策略（1 ~ 3）后面
+struct MaskSizePolicy {
+    static constexpr int PROBE_STEP = 1;
+    static constexpr uint32_t ID = 4;
+
+    static int nextSize(int n) {
+        int size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return hashVal & (size - 1);
+    }
+};
+
+// 表长为 2 的幂，下标取哈希值最高的 log2(size) 位：hash >> (64 - log2(size))
+// 给 FibonacciHash 这种“高位好、低位差”的乘法散列用，两者合起来就是 Fibonacci hashing
+// 先右移 1 位再移 63 - log2(size) 位，表长为 1 时也不会出现移 64 位的未定义行为
+struct FibonacciSizePolicy {
+    static constexpr int PROBE_STEP = 1;
+    static constexpr uint32_t ID = 5;
+
+    static int nextSize(int n) {
+        int size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // size 必须是 2 的幂（nextSize 保证这一点），否则 log2 算出来的位数不对，会取错高位
+    static size_t index(size_t hashVal, size_t size) {
+        return static_cast<size_t>((static_cast<uint64_t>(hashVal) >> 1) >> (63 - log2(size)));
+    }
+
+private:
+    static int log2(size_t size) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(static_cast<unsigned long long>(size));
+#else
+        int shift = 0;
+        while (size > 1) {
+            size >>= 1;
+            ++shift;
+        }
+        return shift;
+#endif
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用这些哈希函数和容量策略
+// 它们在 #include 之前定义 HASH_FUNCTIONS_NO_MAIN，跳过下面的 main
+#ifndef HASH_FUNCTIONS_NO_MAIN
+
+// 步长为 4096 的 key 放进 2 的幂长的表，统计用到了多少个不同的位置
+template<class Hash, class SizePolicy>
+int usedSlots(size_t size) {
+    std::vector<bool> used(size, false);
+    int count = 0;
+    for (uint64_t i = 0; i < size; ++i) {
+        size_t index = SizePolicy::index(Hash{}(i * 4096), size);
+        count += !used[index];
+        used[index] = true;
+    }
+    return count;
+}
+
+int main() {
+    const size_t size = 1024;
+    std::cout << "1024 keys i * 4096 in a 1024-slot table, distinct slots used:" << std::endl;
+    std::cout << "  identity  + mask:      " << usedSlots<IdentityHash, MaskSizePolicy>(size) << std::endl;     // 1
+    std::cout << "  fibonacci + mask:      " << usedSlots<FibonacciHash, MaskSizePolicy>(size) << std::endl;    // 1
+    std::cout << "  fibonacci + high bits: " << usedSlots<FibonacciHash, FibonacciSizePolicy>(size) << std::endl;
+    std::cout << "  wyhash    + mask:      " << usedSlots<WyHash, MaskSizePolicy>(size) << std::endl;
+    std::cout << "  crc32     + mask:      " << usedSlots<Crc32Hash, MaskSizePolicy>(size) << std::endl;
+    return 0;
+}
+
+#endif    // HASH_FUNCTIONS_NO_MAIN
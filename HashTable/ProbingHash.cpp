@@ -47,11 +47,28 @@
 // 开放寻址法——二次探测法的哈希表实现
 
 #include <algorithm>     // for std::find if needed, but not directly used in open addressing search
+#include <chrono>
+#include <cstdint>
+#include <cstdio>        // for std::remove
+#include <cstring>       // for std::memcpy, std::memcmp
+#include <fstream>
 #include <functional>    // for std::hash
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// 快照的只读视图用 mmap 打开文件，只在 POSIX 系统上可用，其他平台退化为把文件整个读进内存
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PROBING_HASH_HAS_MMAP 1
+#endif
+
 // --- 全局辅助函数 ---
 
 // 辅助函数：判断一个数是否为素数
@@ -87,16 +104,151 @@ int nextPrime(int n) {
     return n;
 }
 
+// --- 哈希函数 ---
+
+// 表通过模板参数 Hash 计算哈希值，默认是 DefaultHash，一般类型就是 std::hash
+// 注意 libstdc++ 的 std::hash<int> 是恒等函数，连续或等间隔的整数 key 直接取模时分布很差，
+// 这时可以换成 HashFunctions.cpp 里的哈希函数（例如 FibonacciHash），对比见 HashFunctionBench.cpp
+// 每个哈希函数带一个互不相同的 ID，写进快照文件头，打开快照时用来核对哈希函数是否一致
+template<class T>
+struct DefaultHash {
+    static constexpr uint32_t ID = 1;
+
+    size_t operator()(const T &x) const {
+        return std::hash<T>{}(x);
+    }
+};
+
+// std::string 的透明（transparent）哈希：用 string_view 计算，string、string_view、const char * 算出的哈希值相同
+// 定义了 is_transparent，表就允许直接用 string_view 等类型查找，不必先构造一个临时的 std::string（那意味着一次内存分配）
+template<>
+struct DefaultHash<std::string> {
+    using is_transparent = void;
+    static constexpr uint32_t ID = 1;
+
+    size_t operator()(std::string_view s) const {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+// --- 容量策略 ---
+
+// 表长怎么取、哈希值怎么映射到下标，是一对绑定在一起的选择，这里把它抽成模板参数 SizePolicy
+// 1. PrimeSizePolicy：表长取质数，下标 = hash % 表长（就是文件开头介绍的除留余数法）
+//    质数表长能“打散”质量一般的哈希值，但 64 位取模是一条很慢的除法指令，每次操作都要做一次
+// 2. PowerOfTwoSizePolicy：表长取 2 的幂，下标 = mix(hash) & (表长 - 1)
+//    位与只取低位，而 std::hash<int> 是恒等函数，低位规律性很强，所以必须先用一个混合函数把高位的信息搅到低位
+// 3. FastRangeSizePolicy：Lemire 的 fastrange，下标 = (mix(hash) 的高 32 位 * 表长) >> 32
+//    用一次乘法和移位把 [0, 2^32) 等比例缩放到 [0, 表长)，对表长没有要求，也不需要除法
+// nextPrime 的试除只在 rehash 时调用一次，真正的热点是每次操作都要做的取模
+
+// 辅助函数：64 位混合函数（MurmurHash3 的 fmix64）
+// 输入的每一位都会影响输出的每一位，连续的整数经过混合后也会均匀分布
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 对于开放寻址，表长还决定了探测序列能否覆盖整张表，所以策略里还要给出探测偏移量的增量 PROBE_STEP：
+//    质数表长：偏移量 1, 3, 5, ...，即平方探测 1, 4, 9, ...（表长为质数、装填因子不超过 0.5 时一定能找到空位）
+//    2 的幂表长：偏移量 1, 2, 3, ...，即三角数探测 1, 3, 6, ...（表长为 2 的幂时恰好遍历所有位置）
+// ID 是每个策略互不相同的编号，写进快照文件头；PROBE_STEP 相同的两个策略下标映射也可能完全不同，只核对 PROBE_STEP 不够
+struct PrimeSizePolicy {
+    static constexpr int PROBE_STEP = 2;
+    static constexpr uint32_t ID = 1;
+
+    static int nextSize(int n) {
+        return nextPrime(n);
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return hashVal % size;
+    }
+};
+
+struct PowerOfTwoSizePolicy {
+    static constexpr int PROBE_STEP = 1;
+    static constexpr uint32_t ID = 2;
+
+    static int nextSize(int n) {
+        int size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return mixHash(hashVal) & (size - 1);
+    }
+};
+
+// fastrange 对表长没有要求，这里仍然取质数表长，以保留平方探测的覆盖性质
+// 质数只在 rehash 时计算，热路径上已经没有除法了
+struct FastRangeSizePolicy {
+    static constexpr int PROBE_STEP = 2;
+    static constexpr uint32_t ID = 3;
+
+    static int nextSize(int n) {
+        return nextPrime(n);
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return static_cast<size_t>(((mixHash(hashVal) >> 32) * static_cast<uint64_t>(size)) >> 32);
+    }
+};
+
+// --- 快照格式 ---
+
+// 重启后逐个 insert 重建一张大表要很久，快照把整张表原样写到一个文件里，之后用 mmap 映射回来就能直接查找
+// 文件布局（本机字节序）：
+//    [SnapshotHeader][控制字节，每个槽位 1 字节][填充到 64 字节对齐][槽位数组，每个槽位一个 HashedObj]
+// 控制字节就是槽位的 EntryType（ACTIVE / EMPTY / DELETED）。墓碑要原样保留，否则会截断其他元素的探测序列
+// 槽位数组中非 ACTIVE 的位置内容没有意义，查找时不会去比较
+// 限制：
+//    1. 元素必须可平凡复制（trivially copyable）：std::string 这样的元素里存的是指针，写到文件里没有意义
+//    2. 哈希值在不同进程之间必须一致（整数的 std::hash 是恒等函数，满足），读取时也要用同样的 SizePolicy 和 Hash
+//       文件头记录了 SizePolicy::ID 和 Hash::ID，打开时核对；没有 ID 的自定义 Hash 记为 0，这种情况无法发现哈希函数不一致
+struct SnapshotHeader {
+    char magic[8];           // 固定为 SNAPSHOT_MAGIC
+    uint32_t elementSize;    // sizeof(HashedObj)，打开时核对
+    uint32_t sizePolicyId;   // SizePolicy::ID，打开时核对
+    uint32_t hashId;         // SnapshotHashId<Hash>::value，打开时核对
+    uint32_t reserved;       // 填充，写为 0
+    uint64_t capacity;       // 表长
+    uint64_t activeCount;    // 活跃元素数量
+    uint64_t slotOffset;     // 槽位数组在文件中的偏移量
+    uint64_t fileSize;       // 文件总长度，用于发现被截断的文件
+};
+
+constexpr char SNAPSHOT_MAGIC[8] = {'P', 'H', 'S', 'N', 'A', 'P', '0', '2'};
+
+// 取 Hash::ID，Hash 没有定义 ID 时为 0
+template<class Hash, class = void>
+struct SnapshotHashId {
+    static constexpr uint32_t value = 0;
+};
+
+template<class Hash>
+struct SnapshotHashId<Hash, std::void_t<decltype(Hash::ID)>> {
+    static constexpr uint32_t value = Hash::ID;
+};
+
 // --- 模板类 `HashTable` ---
 
-template<class HashedObj>
+template<class HashedObj, class SizePolicy = PrimeSizePolicy, class Hash = DefaultHash<HashedObj>>
 class HashTable {
 public:
     // 定义槽位状态枚举
     enum EntryType {
         ACTIVE,    // 包含活跃元素
         EMPTY,     // 空槽位，从未被使用或已清空
-        DELETED    // 元素已被逻辑删除
+        DELETED,   // 元素已被逻辑删除
+        PENDING    // 仅在原地清理墓碑的过程中出现：元素有效，但还没有被重新安置
     };
 
     // 哈希表的槽位结构
@@ -108,11 +260,26 @@ public:
         HashEntry(const HashedObj &e = HashedObj(), EntryType i = EMPTY) : element(e), info(i) {}
     };
 
+    // 探测统计信息，用于在性能退化之前观察到它
+    // ASL 的定义见文件开头
+    struct ProbeStats {
+        int activeCount;               // 活跃元素数量
+        int tombstoneCount;            // 墓碑（DELETED）数量
+        int capacity;                  // 表长
+        double loadFactor;             // 装填因子 = 活跃元素 / 表长
+        double occupancy;              // 占用率 = (活跃元素 + 墓碑) / 表长，真正决定探测长度的是它
+        double avgSuccessfulProbe;     // ASL(success)：查找每个活跃元素所需探测次数的平均值
+        int maxSuccessfulProbe;        // 最长的成功查找探测次数
+        double avgUnsuccessfulProbe;   // ASL(failure)：从每个位置出发，直到遇到 EMPTY 的探测次数平均值
+        int rehashCount;               // 扩容 rehash 的次数
+        int compactionCount;           // 原地清理墓碑的次数
+    };
+
     // 构造函数：初始化哈希表
     // 确保表的大小是素数，这对于二次探测非常重要
     // 确保 initialSize 即使不是素数也能得到一个合适的素数大小
     // 初始时 array 会自动用 HashEntry 的默认构造函数填充 EMPTY 状态
-    explicit HashTable(int initialSize = 101) : array(nextPrime(initialSize)) {
+    explicit HashTable(int initialSize = 101) : array(SizePolicy::nextSize(initialSize)) {
         makeEmpty();    // 明确将所有槽位设置为 EMPTY，并重置计数
     }
 
@@ -121,9 +288,17 @@ public:
         return isActive(findPos(x));    // 存在的基础上，必须是活跃状态，才能算存在
     }
 
+    // 异构查找：哈希函数是透明的时候（例如 HashedObj 为 std::string），可以直接用 string_view、const char * 查找
+    // Key 必须能和 HashedObj 用 == 比较
+    template<class Key, class H = Hash, class = typename H::is_transparent>
+    bool contains(const Key &key) const {
+        return isActive(findPos(key));
+    }
+
     // 清空哈希表
     void makeEmpty() {
         currentActiveSize = 0;    // 重置活跃元素计数
+        currentDeletedSize = 0;   // 墓碑也一并清掉
         // 将所有槽位标记为 EMPTY，懒惰删除
         // 懒惰删除这个思想很关键，每个槽位用一个结构体封装也很巧妙
         for (int i = 0; i < array.size(); ++i) {
@@ -131,41 +306,81 @@ public:
         }
     }
 
-    // 插入元素
-    bool insert(const HashedObj &x) {
-        int currentPos = findPos(x);    // 查找元素位置或插入位置
+    // 批量查找：keys 中共 count 个元素，results 非空时把每个元素是否存在写到 results[i]，返回存在的个数
+    // 逐个 contains 时，每次探测都要等一次 cache miss（表大于 cache 时就是一次内存访问，约 100ns），CPU 大部分时间在空等
+    // 批量查找把一批 key 分成两遍处理：
+    //    1. 先算出所有 key 的哈希位置，对每个位置发出预取（prefetch）指令，这些内存访问会同时进行
+    //    2. 再逐个完成探测，此时槽位大概率已经在 cache 中了
+    // 多个 cache miss 的等待时间重叠在一起，吞吐量取决于内存带宽而不是内存延迟
+    // 每次只预取 BATCH_SIZE 个，太多的话先取进来的会在用到之前被挤出 cache
+    int containsBatch(const HashedObj *keys, size_t count, bool *results = nullptr) const {
+        int found = 0;
+        int positions[BATCH_SIZE];
+        for (size_t base = 0; base < count; base += BATCH_SIZE) {
+            int n = static_cast<int>(std::min<size_t>(BATCH_SIZE, count - base));
+            for (int i = 0; i < n; ++i) {
+                positions[i] = myHash(keys[base + i]);
+                prefetch(&array[positions[i]]);
+            }
+            for (int i = 0; i < n; ++i) {
+                bool hit = isActive(findPos(keys[base + i], positions[i]));
+                found += hit;
+                if (results != nullptr) {
+                    results[base + i] = hit;
+                }
+            }
+        }
+        return found;
+    }
 
-        // 如果找到的位置是 ACTIVE，说明元素已存在，无需重复插入
-        if (isActive(currentPos)) {
-            return false;
+    // 批量插入，返回实际插入（之前不存在）的元素个数
+    // 和 containsBatch 一样先算哈希、预取，再逐个插入
+    // 插入过程中可能触发 rehash，表长变了之前算好的位置就失效了，这一批剩下的元素重新计算位置
+    int insertBatch(const HashedObj *keys, size_t count) {
+        int inserted = 0;
+        int positions[BATCH_SIZE];
+        for (size_t base = 0; base < count; base += BATCH_SIZE) {
+            int n = static_cast<int>(std::min<size_t>(BATCH_SIZE, count - base));
+            size_t prefetchedSize = array.size();
+            for (int i = 0; i < n; ++i) {
+                positions[i] = myHash(keys[base + i]);
+                prefetch(&array[positions[i]]);
+            }
+            for (int i = 0; i < n; ++i) {
+                int startPos = array.size() == prefetchedSize ? positions[i] : myHash(keys[base + i]);
+                inserted += insertAt(keys[base + i], startPos);
+            }
         }
+        return inserted;
+    }
 
-        // 找到的位置不是 ACTIVE (可能是 EMPTY 或 DELETED)，可以插入
-        array[currentPos] = HashEntry(x, ACTIVE);
-        currentActiveSize++;    // 增加活跃元素计数
+    // 插入元素
+    bool insert(const HashedObj &x) {
+        return insertAt(x, myHash(x));
+    }
 
-        // 检查负载因子。对于二次探测，负载因子通常建议不超过 0.5。
-        // currentActiveSize 是活跃元素数量
-        // array.size() 是哈希表总大小
-        if (currentActiveSize > array.size() / 2) {
-            rehash();
-        }
-        return true;
+    // 插入元素（移动版本）：x 直接移动进槽位，不拷贝
+    bool insert(HashedObj &&x) {
+        int startPos = myHash(x);
+        return insertAt(std::move(x), startPos);
+    }
+
+    // 用 args 构造一个元素并插入
+    // 开放寻址要先有元素才能计算哈希值、判断是否重复，所以构造之后按移动版本插入，全程没有拷贝
+    template<class... Args>
+    bool emplace(Args &&...args) {
+        return insert(HashedObj(std::forward<Args>(args)...));
     }
 
     // 删除元素（逻辑删除）
     bool remove(const HashedObj &x) {
-        int currentPos = findPos(x);    // 查找元素位置
-
-        // 如果元素不存在或不在活跃状态，则无法删除
-        if (!isActive(currentPos)) {
-            return false;
-        }
+        return removeAt(findPos(x));
+    }
 
-        // 标记为 DELETED
-        array[currentPos].info = DELETED;
-        currentActiveSize--;    // 减少活跃元素计数（重要修复）
-        return true;
+    // 异构删除，要求同 contains
+    template<class Key, class H = Hash, class = typename H::is_transparent>
+    bool remove(const Key &key) {
+        return removeAt(findPos(key));
     }
 
     // 获取当前活跃元素的数量
@@ -178,9 +393,79 @@ public:
         return array.size();
     }
 
+    // 获取当前墓碑的数量
+    int tombstoneCount() const {
+        return currentDeletedSize;
+    }
+
+    // 统计探测长度等信息
+    // 需要把每个元素的探测序列重新走一遍，是 O(表长 * 探测长度) 的操作，只用于观察，不要放在热路径上
+    ProbeStats probeStats() const {
+        ProbeStats stats;
+        stats.activeCount = currentActiveSize;
+        stats.tombstoneCount = currentDeletedSize;
+        stats.capacity = array.size();
+        stats.loadFactor = static_cast<double>(currentActiveSize) / array.size();
+        stats.occupancy = static_cast<double>(currentActiveSize + currentDeletedSize) / array.size();
+        stats.rehashCount = rehashCount;
+        stats.compactionCount = compactionCount;
+
+        // 成功查找：对每个活跃元素，从它的哈希位置出发，数一数走几步能找到它
+        long long totalSuccess = 0;
+        stats.maxSuccessfulProbe = 0;
+        for (int i = 0; i < array.size(); ++i) {
+            if (array[i].info == ACTIVE) {
+                int probes = probeLength(myHash(array[i].element), i);
+                totalSuccess += probes;
+                stats.maxSuccessfulProbe = std::max(stats.maxSuccessfulProbe, probes);
+            }
+        }
+        stats.avgSuccessfulProbe = currentActiveSize == 0 ? 0.0 : static_cast<double>(totalSuccess) / currentActiveSize;
+
+        // 不成功查找：假设哈希值均匀落在每个位置上，从每个位置出发走到 EMPTY 为止
+        long long totalFailure = 0;
+        for (int i = 0; i < array.size(); ++i) {
+            totalFailure += probeLength(i, -1);
+        }
+        stats.avgUnsuccessfulProbe = static_cast<double>(totalFailure) / array.size();
+        return stats;
+    }
+
+    // 把表写成快照文件（格式见 SnapshotHeader），成功返回 true
+    // 先在内存中拼出完整的文件内容，再一次 write 写出
+    bool saveSnapshot(const std::string &path) const {
+        static_assert(std::is_trivially_copyable<HashedObj>::value, "snapshot requires a trivially copyable element type");
+
+        size_t capacity = array.size();
+        SnapshotHeader header;
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.elementSize = sizeof(HashedObj);
+        header.sizePolicyId = SizePolicy::ID;
+        header.hashId = SnapshotHashId<Hash>::value;
+        header.reserved = 0;
+        header.capacity = capacity;
+        header.activeCount = currentActiveSize;
+        header.slotOffset = (sizeof(SnapshotHeader) + capacity + 63) / 64 * 64;    // 槽位数组按 cache line 对齐
+        header.fileSize = header.slotOffset + capacity * sizeof(HashedObj);
+
+        std::vector<char> buffer(header.fileSize);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        char *control = buffer.data() + sizeof(header);
+        char *slots = buffer.data() + header.slotOffset;
+        for (size_t i = 0; i < capacity; ++i) {
+            control[i] = static_cast<char>(array[i].info);
+            std::memcpy(slots + i * sizeof(HashedObj), &array[i].element, sizeof(HashedObj));
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(buffer.data(), buffer.size());
+        return static_cast<bool>(out.flush());
+    }
+
     // 打印哈希表内容（用于调试）
     void printHashTable() const {
-        std::cout << "--- Hash Table Contents (Active: " << currentActiveSize << ", Capacity: " << array.size() << ") ---" << std::endl;
+        std::cout << "--- Hash Table Contents (Active: " << currentActiveSize << ", Deleted: " << currentDeletedSize
+                  << ", Capacity: " << array.size() << ") ---" << std::endl;
         for (int i = 0; i < array.size(); ++i) {
             std::cout << "Bucket " << i << ": ";
             if (array[i].info == ACTIVE) {
@@ -198,6 +483,72 @@ public:
 private:
     std::vector<HashEntry> array;    // 存储哈希表槽位的vector
     int currentActiveSize;           // 当前活跃元素的数量
+    int currentDeletedSize = 0;      // 当前墓碑（DELETED）的数量
+    int rehashCount = 0;             // 扩容次数，仅用于统计
+    int compactionCount = 0;         // 原地清理次数，仅用于统计
+
+    // 批量操作每次预取的元素个数
+    static constexpr int BATCH_SIZE = 16;
+
+    // 预取 p 所在的 cache line，只是提示，不会改变程序语义，不支持的编译器上什么都不做
+    static void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p, 0, 1);
+#else
+        (void)p;
+#endif
+    }
+
+    // 从已经算好的哈希位置 startPos 开始，插入元素 x
+    // x 是右值时移动进槽位，否则拷贝
+    template<class T>
+    bool insertAt(T &&x, int startPos) {
+        int currentPos = findPos(x, startPos);    // 查找元素位置或插入位置
+
+        // 如果找到的位置是 ACTIVE，说明元素已存在，无需重复插入
+        if (isActive(currentPos)) {
+            return false;
+        }
+
+        // 找到的位置不是 ACTIVE (可能是 EMPTY 或 DELETED)，可以插入
+        // findPos 只会在 DELETED 槽位里的旧元素恰好等于 x 时停在 DELETED 上，此时复用这个墓碑
+        if (array[currentPos].info == DELETED) {
+            currentDeletedSize--;
+        }
+        array[currentPos].element = std::forward<T>(x);
+        array[currentPos].info = ACTIVE;
+        currentActiveSize++;    // 增加活跃元素计数
+
+        // 检查负载因子。对于二次探测，负载因子通常建议不超过 0.5。
+        // 但探测时墓碑和活跃元素一样会被跳过，真正决定探测长度的是 活跃元素 + 墓碑
+        // 而且二次探测只有在表中至少一半是 EMPTY 时，才保证一定能找到空位
+        // 所以这里用二者之和来判断：
+        // 1. 活跃元素本身就多（超过表长的 1/4），说明表确实满了，扩容
+        // 2. 主要是墓碑多，容量是够的，原地清理墓碑即可，不需要再分配一个数组
+        // 清理后墓碑为 0、活跃元素不超过 1/4，下一次清理至少要再过 1/4 表长次操作，均摊仍是 O(1)
+        if (currentActiveSize + currentDeletedSize > array.size() / 2) {
+            if (currentActiveSize > array.size() / 4) {
+                rehash();
+            } else {
+                compactTombstones();
+            }
+        }
+        return true;
+    }
+
+    // 删除位置 currentPos 上的元素（findPos 的结果）
+    bool removeAt(int currentPos) {
+        // 如果元素不存在或不在活跃状态，则无法删除
+        if (!isActive(currentPos)) {
+            return false;
+        }
+
+        // 标记为 DELETED
+        array[currentPos].info = DELETED;
+        currentActiveSize--;    // 减少活跃元素计数（重要修复）
+        currentDeletedSize++;   // 记录墓碑数量，它决定了何时需要清理
+        return true;
+    }
 
     // 辅助函数：判断给定位置的槽位是否活跃
     bool isActive(int currentPos) const {
@@ -206,18 +557,26 @@ private:
 
     // 查找元素 x 的位置
     // 如果 x 存在，返回其位置；如果 x 不存在，返回它应该插入的位置
-    // 这里实现的是标准平方探测，即1, 4, 9, 16, ... 的方式探测
+    // 这里实现的是标准平方探测，即1, 4, 9, 16, ... 的方式探测（2 的幂表长时为三角数探测，见 SizePolicy）
     // 并没有使用双向平方探测，即 -1, 1, -4, 4, -9, 9, ... 的方式
-    int findPos(const HashedObj &x) const {
+    // Key 为 HashedObj 或者透明哈希允许的其他类型
+    template<class Key>
+    int findPos(const Key &x) const {
+        return findPos(x, myHash(x));
+    }
+
+    // 同上，初始哈希位置 startPos 已经由调用者算好（批量操作中提前算出来用于预取）
+    template<class Key>
+    int findPos(const Key &x, int startPos) const {
         int offset = 1;
-        int currentPos = myHash(x);    // 初始哈希位置
+        int currentPos = startPos;    // 初始哈希位置
 
         // 探测循环：
         // 1. 槽位不是 EMPTY (可能 ACTIVE 或 DELETED)
         // 2. 槽位中的元素不是 x (我们还没有找到 x)
         while (array[currentPos].info != EMPTY && array[currentPos].element != x) {
             currentPos += offset;    // 加上当前偏移量
-            offset += 2;             // 增加偏移量，为下次探测做准备 (1, 3, 5, 7...)
+            offset += SizePolicy::PROBE_STEP;    // 增加偏移量，为下次探测做准备 (1, 3, 5, 7...)
 
             // 处理循环回绕
             if (currentPos >= array.size()) {
@@ -227,12 +586,78 @@ private:
         return currentPos;
     }
 
+    // 沿着从 startPos 开始的探测序列，数出到达 targetPos 需要探测几次（探测本身算第 1 次）
+    // targetPos 为 -1 时，数到第一个 EMPTY 为止，即一次不成功查找的长度
+    int probeLength(int startPos, int targetPos) const {
+        int offset = 1;
+        int currentPos = startPos;
+        int probes = 1;
+        while (currentPos != targetPos && array[currentPos].info != EMPTY) {
+            currentPos += offset;
+            offset += SizePolicy::PROBE_STEP;
+            if (currentPos >= array.size()) {
+                currentPos -= array.size();
+            }
+            probes++;
+        }
+        return probes;
+    }
+
+    // 原地清理墓碑：表长不变，也不分配第二个数组
+    // 思路：
+    // 1. 先把所有 DELETED 改成 EMPTY，把所有 ACTIVE 改成 PENDING（“待安置”）
+    // 2. 从前往后扫描，对每个 PENDING 槽位 i 中的元素 x，沿 x 的探测序列找到第一个不是 ACTIVE 的位置 target：
+    //    a. target == i：x 已经在它该在的位置，标记为 ACTIVE
+    //    b. target 是 EMPTY：把 x 搬过去，i 变为 EMPTY
+    //    c. target 是另一个 PENDING：交换两者，target 处的 x 安置完毕，i 换来了一个新的待安置元素，继续处理 i
+    // 为什么正确：
+    // 每个元素被安置时，它探测序列上前面的位置全是 ACTIVE；而 ACTIVE 在整个过程中不会再改变，
+    // 所以后续把某个位置变为 EMPTY 时，不会截断任何已安置元素的探测序列
+    // 为什么会停：
+    // x 当初就是沿着自己的探测序列插入到 i 的，所以最迟走到 i 也会停下；每次交换都会多安置一个元素
+    void compactTombstones() {
+        for (auto &entry : array) {
+            if (entry.info == DELETED) {
+                entry.info = EMPTY;
+            } else if (entry.info == ACTIVE) {
+                entry.info = PENDING;
+            }
+        }
+        currentDeletedSize = 0;
+
+        for (int i = 0; i < array.size(); ++i) {
+            while (array[i].info == PENDING) {
+                int offset = 1;
+                int target = myHash(array[i].element);
+                while (array[target].info == ACTIVE) {
+                    target += offset;
+                    offset += SizePolicy::PROBE_STEP;
+                    if (target >= array.size()) {
+                        target -= array.size();
+                    }
+                }
+
+                if (target == i) {
+                    array[i].info = ACTIVE;
+                } else if (array[target].info == EMPTY) {
+                    array[target].element = std::move(array[i].element);
+                    array[target].info = ACTIVE;
+                    array[i].info = EMPTY;
+                } else {    // PENDING
+                    std::swap(array[i].element, array[target].element);
+                    array[target].info = ACTIVE;
+                }
+            }
+        }
+        compactionCount++;
+    }
+
     // 再散列函数：当哈希表负载过高时进行扩容和重建
     void rehash() {
         std::vector<HashEntry> oldArray = std::move(array);    // 使用移动语义，避免深拷贝
 
-        // 调整新哈希表的大小为当前大小的两倍的下一个素数
-        array.resize(nextPrime(2 * oldArray.size()));
+        // 调整新哈希表的大小为当前大小的两倍的下一个素数（由 SizePolicy 决定）
+        array.resize(SizePolicy::nextSize(2 * oldArray.size()));
 
         // 遍历新表，将其所有槽位初始化为 EMPTY
         // (resize会默认调用HashEntry的默认构造，所以这里实际是多余的，但写上确保语义明确)
@@ -241,31 +666,304 @@ private:
         }
 
         currentActiveSize = 0;    // 重置活跃元素计数，因为后续 insert 会重新计数
+        currentDeletedSize = 0;   // 墓碑不会被搬到新表中
+        rehashCount++;
 
         // 遍历旧哈希表中的所有活跃元素，并重新插入到新的哈希表中
-        for (const auto &entry : oldArray) {    // 使用范围for循环遍历旧数组
+        for (auto &entry : oldArray) {          // 使用范围for循环遍历旧数组
             if (entry.info == ACTIVE) {
-                insert(entry.element);          // 重新插入，这会再次调用 myHash 和 insert 逻辑
-                                                // 这里的 insert 调用会增加 currentActiveSize，
-                                                // 但不会再次触发 rehash，因为是在 rehash 内部。
+                insert(std::move(entry.element));    // 重新插入（旧表马上销毁，直接移动），这会再次调用 myHash 和 insert 逻辑
+                                                     // 这里的 insert 调用会增加 currentActiveSize，
+                                                     // 但不会再次触发 rehash，因为是在 rehash 内部。
             }
         }
     }
 
     // 核心哈希映射函数
     // 负责将 HashedObj 映射到 `array` 数组的有效索引
-    int myHash(const HashedObj &x) const {
-        // 使用 std::hash 模板，它为基本类型和 std::string 等提供了默认实现
-        size_t hashVal = std::hash<HashedObj>{}(x);
+    // Key 是 HashedObj 以外的类型时（异构查找），透明的 Hash 保证它和对应的 HashedObj 算出相同的哈希值
+    template<class Key>
+    int myHash(const Key &x) const {
+        // 默认的 DefaultHash 内部使用 std::hash 模板，它为基本类型和 std::string 等提供了默认实现
+        size_t hashVal = Hash{}(x);
 
-        // 对哈希值取模，确保它落在 [0, array.size() - 1] 范围内
-        hashVal %= array.size();
+        // 由 SizePolicy 把哈希值映射到 [0, array.size() - 1] 范围内（默认就是取模）
+        hashVal = SizePolicy::index(hashVal, array.size());
 
         // std::hash 返回的是 size_t (无符号)，所以 hashVal 不会是负数
         return static_cast<int>(hashVal);
     }
 };
 
+// --- 只读快照视图 ---
+
+// 打开 saveSnapshot 写出的文件，直接在映射的内存上查找，没有任何反序列化：
+// 打开只是一次 mmap 加上核对文件头，页面在第一次被访问时才由操作系统读入，所以打开的耗时和表的大小无关
+// 查找逻辑和 HashTable::findPos 相同：同样的哈希值、同样的探测序列，只是槽位状态从控制字节里读
+// 视图是只读的，不能插入和删除；需要修改时还是要建一张 HashTable
+template<class HashedObj, class SizePolicy = PrimeSizePolicy, class Hash = DefaultHash<HashedObj>>
+class HashTableView {
+public:
+    HashTableView() = default;
+
+    explicit HashTableView(const std::string &path) {
+        open(path);
+    }
+
+    ~HashTableView() {
+        close();
+    }
+
+    // 视图持有映射，不允许拷贝
+    HashTableView(const HashTableView &) = delete;
+    HashTableView &operator=(const HashTableView &) = delete;
+
+    // 打开快照文件。文件不存在、被截断、或者和模板参数（元素大小、容量策略、哈希函数）不匹配时返回 false
+    bool open(const std::string &path) {
+        static_assert(std::is_trivially_copyable<HashedObj>::value, "snapshot requires a trivially copyable element type");
+
+        close();
+        const char *base = mapFile(path);
+        if (base == nullptr) {
+            return false;
+        }
+
+        SnapshotHeader header;
+        bool valid = mappedSize >= sizeof(header);
+        if (valid) {
+            std::memcpy(&header, base, sizeof(header));
+            valid = std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.elementSize == sizeof(HashedObj)
+                    && header.sizePolicyId == SizePolicy::ID && header.hashId == SnapshotHashId<Hash>::value && header.capacity > 0 && header.fileSize == mappedSize
+                    && header.slotOffset >= sizeof(header) + header.capacity && header.slotOffset % alignof(HashedObj) == 0
+                    && header.slotOffset + header.capacity * sizeof(HashedObj) == mappedSize;
+        }
+        if (!valid) {
+            close();
+            return false;
+        }
+
+        control = reinterpret_cast<const unsigned char *>(base + sizeof(header));
+        slots = reinterpret_cast<const HashedObj *>(base + header.slotOffset);
+        tableSize = header.capacity;
+        activeCount = header.activeCount;
+        return true;
+    }
+
+    // 解除映射，视图回到未打开的状态
+    void close() {
+#ifdef PROBING_HASH_HAS_MMAP
+        if (mapping != nullptr) {
+            munmap(mapping, mappedSize);
+            mapping = nullptr;
+        }
+#else
+        std::vector<uint64_t>().swap(fileBuffer);
+#endif
+        control = nullptr;
+        slots = nullptr;
+        tableSize = 0;
+        activeCount = 0;
+        mappedSize = 0;
+    }
+
+    bool isOpen() const {
+        return slots != nullptr;
+    }
+
+    // 检查元素是否存在
+    bool contains(const HashedObj &x) const {
+        return find(x) != nullptr;
+    }
+
+    // 查找元素，返回它在映射内存中的地址，不存在时返回 nullptr
+    const HashedObj *find(const HashedObj &x) const {
+        if (!isOpen()) {
+            return nullptr;
+        }
+        size_t currentPos = SizePolicy::index(Hash{}(x), tableSize);
+        size_t offset = 1;
+        while (control[currentPos] != EMPTY) {
+            if (control[currentPos] == ACTIVE && slots[currentPos] == x) {
+                return &slots[currentPos];
+            }
+            currentPos += offset;
+            offset += SizePolicy::PROBE_STEP;
+            if (currentPos >= tableSize) {
+                currentPos -= tableSize;
+            }
+        }
+        return nullptr;
+    }
+
+    // 获取活跃元素的数量
+    int size() const {
+        return static_cast<int>(activeCount);
+    }
+
+    // 获取表长
+    int capacity() const {
+        return static_cast<int>(tableSize);
+    }
+
+private:
+    static constexpr unsigned char ACTIVE = HashTable<HashedObj, SizePolicy, Hash>::ACTIVE;
+    static constexpr unsigned char EMPTY = HashTable<HashedObj, SizePolicy, Hash>::EMPTY;
+
+    const unsigned char *control = nullptr;    // 控制字节，指向映射内存
+    const HashedObj *slots = nullptr;          // 槽位数组，指向映射内存
+    size_t tableSize = 0;
+    size_t activeCount = 0;
+    size_t mappedSize = 0;                     // 文件长度
+#ifdef PROBING_HASH_HAS_MMAP
+    void *mapping = nullptr;
+#else
+    std::vector<uint64_t> fileBuffer;          // 没有 mmap 时文件读到这里，用 uint64_t 保证对齐
+#endif
+
+    // 把整个文件映射（或读入）到内存，返回首地址，失败时返回 nullptr
+    const char *mapFile(const std::string &path) {
+#ifdef PROBING_HASH_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);    // 映射建立之后，文件描述符就可以关掉了
+        if (p == MAP_FAILED) {
+            return nullptr;
+        }
+        // 哈希表的访问是随机的，关掉内核的顺序预读
+        madvise(p, static_cast<size_t>(st.st_size), MADV_RANDOM);
+        mapping = p;
+        mappedSize = static_cast<size_t>(st.st_size);
+        return static_cast<const char *>(p);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            return nullptr;
+        }
+        size_t fileSize = static_cast<size_t>(in.tellg());
+        fileBuffer.resize((fileSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char *>(fileBuffer.data()), fileSize)) {
+            std::vector<uint64_t>().swap(fileBuffer);
+            return nullptr;
+        }
+        mappedSize = fileSize;
+        return reinterpret_cast<const char *>(fileBuffer.data());
+#endif
+    }
+};
+
+// 其他文件（例如 RcuProbingHash.cpp）会直接 #include 本文件来复用 HashTable
+// 它们在 #include 之前定义 PROBING_HASH_NO_MAIN，跳过下面的测试代码和 main
+#ifndef PROBING_HASH_NO_MAIN
+
+// --- 容量策略的性能对比 ---
+
+// 用同一组 key 测试一种容量策略：先插入，再做同样数量的命中查找和不命中查找
+// key 的最低位都是 0，key | 1 一定不在表中
+template<class Policy>
+void benchmarkSizePolicy(const char *name, const std::vector<int> &keys) {
+    HashTable<int, Policy> table;
+    auto start = std::chrono::steady_clock::now();
+    for (int k : keys) {
+        table.insert(k);
+    }
+    auto inserted = std::chrono::steady_clock::now();
+    int found = 0;
+    for (int k : keys) {
+        found += table.contains(k);
+        found += table.contains(k | 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double insertMs = std::chrono::duration<double, std::milli>(inserted - start).count();
+    double lookupMs = std::chrono::duration<double, std::milli>(end - inserted).count();
+    std::cout << "  " << name << ": insert " << insertMs << " ms, lookup " << lookupMs << " ms, capacity " << table.capacity()
+              << ", ASL(success) " << table.probeStats().avgSuccessfulProbe
+              << ", found " << found << std::endl;
+}
+
+// --- 批量操作（预取）的性能对比 ---
+
+// 同一组 key，分别用逐个 insert/contains 和每 batch 个一组的 insertBatch/containsBatch 处理，比较耗时
+// 查询一半命中、一半不命中，顺序随机。表要明显大于 cache，预取才有意义
+template<class Table>
+void benchmarkBatch(const std::vector<int> &keys, const std::vector<int> &queries, size_t batch) {
+    Table single, batched;
+    auto start = std::chrono::steady_clock::now();
+    for (int k : keys) {
+        single.insert(k);
+    }
+    auto singleInserted = std::chrono::steady_clock::now();
+    for (size_t base = 0; base < keys.size(); base += batch) {
+        batched.insertBatch(&keys[base], std::min(batch, keys.size() - base));
+    }
+    auto batchInserted = std::chrono::steady_clock::now();
+
+    int singleFound = 0;
+    for (int q : queries) {
+        singleFound += single.contains(q);
+    }
+    auto singleLooked = std::chrono::steady_clock::now();
+    int batchFound = 0;
+    for (size_t base = 0; base < queries.size(); base += batch) {
+        batchFound += batched.containsBatch(&queries[base], std::min(batch, queries.size() - base));
+    }
+    auto batchLooked = std::chrono::steady_clock::now();
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "  insert:   one by one " << ms(start, singleInserted) << " ms, batch " << ms(singleInserted, batchInserted)
+              << " ms (size " << single.size() << " / " << batched.size() << ")" << std::endl;
+    std::cout << "  contains: one by one " << ms(batchInserted, singleLooked) << " ms, batch " << ms(singleLooked, batchLooked)
+              << " ms (found " << singleFound << " / " << batchFound << ")" << std::endl;
+}
+
+// --- 异构查找的性能对比 ---
+
+// 手里只有 string_view 时查找 std::string 表：先构造临时 std::string 再查 vs 直接用 string_view 查
+// key 的长度超过了短字符串优化（SSO）的上限，构造临时 std::string 一定会分配内存
+template<class Table>
+void benchmarkHeterogeneousLookup(int n, int rounds) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < n; ++i) {
+        keys.push_back("user:session:id:" + std::to_string(i * 7919));
+    }
+    Table table;
+    for (const auto &k : keys) {
+        table.insert(k);
+    }
+    std::vector<std::string_view> views(keys.begin(), keys.end());
+
+    auto start = std::chrono::steady_clock::now();
+    int tempFound = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (std::string_view v : views) {
+            tempFound += table.contains(std::string(v));
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    int viewFound = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (std::string_view v : views) {
+            viewFound += table.contains(v);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "  temporary std::string: " << std::chrono::duration<double, std::milli>(middle - start).count() << " ms"
+              << ", string_view: " << std::chrono::duration<double, std::milli>(end - middle).count() << " ms"
+              << " (found " << tempFound << " / " << viewFound << ")" << std::endl;
+}
+
 // --- 主函数测试 ---
 
 int main() {
@@ -324,7 +1022,38 @@ int main() {
     intHashTable.printHashTable();
     std::cout << "Size after makeEmpty: " << intHashTable.size() << std::endl;
 
-    // 2. 测试 string 类型的哈希表
+    // 2. 插入/删除交替进行（churn），观察墓碑与探测长度
+    // 活跃元素数量始终维持在 1000 左右，如果墓碑永远不清理，探测长度会不断变长
+    std::cout << "\n--- Churn test: tombstones and probe lengths ---" << std::endl;
+    HashTable<int> churnTable(4001);
+    for (int i = 0; i < 1000; ++i) {
+        churnTable.insert(i);
+    }
+    auto printStats = [](const HashTable<int>::ProbeStats &s) {
+        std::cout << "active=" << s.activeCount << " tombstones=" << s.tombstoneCount << " capacity=" << s.capacity
+                  << " occupancy=" << s.occupancy << " ASL(success)=" << s.avgSuccessfulProbe
+                  << " max=" << s.maxSuccessfulProbe << " ASL(failure)=" << s.avgUnsuccessfulProbe
+                  << " rehash=" << s.rehashCount << " compaction=" << s.compactionCount << std::endl;
+    };
+    printStats(churnTable.probeStats());
+    for (int round = 1; round <= 5; ++round) {
+        // 每轮删掉最老的 400 个元素，再插入 400 个新元素
+        for (int i = 0; i < 400; ++i) {
+            int oldest = (round - 1) * 400 + i;
+            churnTable.remove(oldest);
+            churnTable.insert(oldest + 1000);
+        }
+        std::cout << "Round " << round << ": ";
+        printStats(churnTable.probeStats());
+    }
+    bool churnOk = churnTable.size() == 1000;
+    for (int i = 2000; i < 3000; ++i) {
+        churnOk &= churnTable.contains(i);
+    }
+    churnOk &= !churnTable.contains(1999);
+    std::cout << "Churn contents check: " << (churnOk ? "OK" : "FAILED") << std::endl;
+
+    // 3. 测试 string 类型的哈希表
     std::cout << "\n--- Testing HashTable with string ---" << std::endl;
     HashTable<std::string> stringHashTable(5);
 
@@ -345,5 +1074,85 @@ int main() {
     stringHashTable.printHashTable();
     std::cout << "Contains 'cherry': " << (stringHashTable.contains("cherry") ? "Yes" : "No") << std::endl;
 
+    // 4. 容量策略对比：质数取模 vs 2 的幂 vs fastrange
+    std::cout << "\n--- Size policy benchmark ---" << std::endl;
+    const int N = 1 << 20;
+    std::vector<int> sequentialKeys(N), randomKeys(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        sequentialKeys[i] = 2 * i;
+        seed = seed * 1664525u + 1013904223u;
+        randomKeys[i] = static_cast<int>(seed & 0x7ffffffe);
+    }
+    std::cout << "Sequential keys:" << std::endl;
+    benchmarkSizePolicy<PrimeSizePolicy>("PrimeSizePolicy     ", sequentialKeys);
+    benchmarkSizePolicy<PowerOfTwoSizePolicy>("PowerOfTwoSizePolicy", sequentialKeys);
+    benchmarkSizePolicy<FastRangeSizePolicy>("FastRangeSizePolicy ", sequentialKeys);
+    std::cout << "Random keys:" << std::endl;
+    benchmarkSizePolicy<PrimeSizePolicy>("PrimeSizePolicy     ", randomKeys);
+    benchmarkSizePolicy<PowerOfTwoSizePolicy>("PowerOfTwoSizePolicy", randomKeys);
+    benchmarkSizePolicy<FastRangeSizePolicy>("FastRangeSizePolicy ", randomKeys);
+
+    // 5. 批量操作：逐个处理 vs 预取后批量处理，每批 256 个（join 中一次探测的典型批量）
+    std::cout << "\n--- Batch insert/lookup with prefetching ---" << std::endl;
+    std::vector<int> queries(2 * N);
+    for (int i = 0; i < 2 * N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        queries[i] = randomKeys[(seed >> 8) % N] | (i & 1);    // 奇数下标的查询一定不命中
+    }
+    benchmarkBatch<HashTable<int>>(randomKeys, queries, 256);
+
+    // 6. 异构查找、移动插入与 emplace
+    std::cout << "\n--- Heterogeneous lookup, move insert and emplace ---" << std::endl;
+    HashTable<std::string> names;
+    std::string longName = "a key that is too long for the small string buffer";
+    names.insert(std::move(longName));    // 移动插入，字符缓冲区直接转移到表中
+    names.emplace(5, 'x');                // 用 std::string(5, 'x') 的参数构造，即 "xxxxx"
+    std::string_view probe = "a key that is too long for the small string buffer";
+    std::cout << "Contains (string_view): " << (names.contains(probe) ? "Yes" : "No") << std::endl;
+    std::cout << "Contains (const char *) 'xxxxx': " << (names.contains("xxxxx") ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 'xxxxx' by string_view: " << (names.remove(std::string_view("xxxxx")) ? "OK" : "Not found") << std::endl;
+    std::cout << "Size: " << names.size() << std::endl;
+    benchmarkHeterogeneousLookup<HashTable<std::string>>(1 << 16, 20);
+
+    // 7. 快照：逐个 insert 重建 vs 保存快照后用 mmap 打开只读视图
+    std::cout << "\n--- Snapshot save and mmap reopen ---" << std::endl;
+    const std::string snapshotPath = "probing_hash_snapshot.bin";
+    auto rebuildStart = std::chrono::steady_clock::now();
+    HashTable<int> persistent;
+    for (int k : randomKeys) {
+        persistent.insert(k);
+    }
+    auto rebuilt = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i += 4) {
+        persistent.remove(randomKeys[i]);    // 留下一些墓碑，快照里也要保留
+    }
+    auto saveStart = std::chrono::steady_clock::now();
+    bool saved = persistent.saveSnapshot(snapshotPath);
+    auto openStart = std::chrono::steady_clock::now();
+    HashTableView<int> view(snapshotPath);
+    auto opened = std::chrono::steady_clock::now();
+    int tableFound = 0;
+    int viewFound = 0;
+    for (int q : queries) {
+        tableFound += persistent.contains(q);
+        viewFound += view.contains(q);
+    }
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "  rebuild by insert: " << ms(rebuildStart, rebuilt) << " ms, save: " << ms(saveStart, openStart)
+              << " ms (" << (saved ? "OK" : "FAILED") << "), open view: " << ms(openStart, opened) << " ms" << std::endl;
+    std::cout << "  view size " << view.size() << ", capacity " << view.capacity() << ", found " << viewFound << " / "
+              << tableFound << " (" << (viewFound == tableFound ? "OK" : "MISMATCH") << ")" << std::endl;
+    view.close();
+    // PROBE_STEP 相同但下标映射不同的策略打不开这个快照
+    HashTableView<int, FastRangeSizePolicy> wrongPolicy(snapshotPath);
+    std::cout << "  open with FastRangeSizePolicy: " << (wrongPolicy.isOpen() ? "opened (WRONG)" : "rejected (OK)") << std::endl;
+    wrongPolicy.close();
+    std::remove(snapshotPath.c_str());
+
     return 0;
 }
+
+#endif    // PROBING_HASH_NO_MAIN
@@ -0,0 +1,440 @@
+// 开放寻址（平方探测）的键值哈希表 HashMap<Key, Value>
+// ProbingHash.cpp 中的 HashTable 只是集合：只能判断元素在不在，没有地方存放 value
+// 如果另外用一个结构按同样的 key 存 value，每次访问都要查两遍
+// HashMap 在槽位里同时存放 key 和 value，find 一次探测就返回 value 的地址，既判断了存在性，又拿到了值
+
+// 探测算法、装填因子、墓碑的处理都和 ProbingHash.cpp 相同，容量策略 SizePolicy 和透明哈希 DefaultHash 也直接复用
+// 不同之处：
+//    1. 扩容（或者墓碑太多需要清理）放在插入之前进行，这样 find、operator[] 返回的地址在下一次插入/删除之前一直有效
+//    2. 清理墓碑时重建一张同样大小的表，不做原地清理，实现简单一些
+
+// 存储布局（模板参数 Layout）：
+//    InterleavedLayout：key、value、状态放在同一个槽位里（数组的每个元素是一个 {key, value, state}）
+//       命中后 value 就在 key 旁边，通常和 key 在同一个 cache line 里，取 value 不需要额外的内存访问
+//    SplitLayout：{key, state} 一个数组，value 单独一个数组，下标一一对应
+//       探测只访问 key 数组，value 很大时一个 cache line 能装下更多的 key，探测更快；代价是命中后取 value 多一次内存访问
+//       适合 value 很大、而查找中不命中（或只判断存在性）占多数的场景
+
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+
+#include <array>
+
+// --- 槽位状态与存储布局 ---
+
+enum class SlotState : unsigned char {
+    EMPTY,      // 空槽位，从未被使用
+    ACTIVE,     // 包含有效的键值对
+    DELETED     // 键值对已被逻辑删除（墓碑）
+};
+
+// key、value、状态交错存放在同一个数组中
+struct InterleavedLayout {
+    template<class Key, class Value>
+    class Storage {
+    public:
+        // 重新分配 n 个槽位，全部为 EMPTY
+        void assign(int n) {
+            slots.assign(n, Slot());
+        }
+
+        int size() const {
+            return slots.size();
+        }
+
+        SlotState &state(int i) {
+            return slots[i].state;
+        }
+
+        SlotState state(int i) const {
+            return slots[i].state;
+        }
+
+        Key &key(int i) {
+            return slots[i].key;
+        }
+
+        const Key &key(int i) const {
+            return slots[i].key;
+        }
+
+        Value &value(int i) {
+            return slots[i].value;
+        }
+
+        const Value &value(int i) const {
+            return slots[i].value;
+        }
+
+        size_t memoryUsage() const {
+            return slots.capacity() * sizeof(Slot);
+        }
+
+    private:
+        struct Slot {
+            Key key = Key();
+            Value value = Value();
+            SlotState state = SlotState::EMPTY;
+        };
+
+        std::vector<Slot> slots;
+    };
+};
+
+// {key, 状态} 一个数组，value 一个数组
+struct SplitLayout {
+    template<class Key, class Value>
+    class Storage {
+    public:
+        void assign(int n) {
+            slots.assign(n, Slot());
+            values.assign(n, Value());
+        }
+
+        int size() const {
+            return slots.size();
+        }
+
+        SlotState &state(int i) {
+            return slots[i].state;
+        }
+
+        SlotState state(int i) const {
+            return slots[i].state;
+        }
+
+        Key &key(int i) {
+            return slots[i].key;
+        }
+
+        const Key &key(int i) const {
+            return slots[i].key;
+        }
+
+        Value &value(int i) {
+            return values[i];
+        }
+
+        const Value &value(int i) const {
+            return values[i];
+        }
+
+        size_t memoryUsage() const {
+            return slots.capacity() * sizeof(Slot) + values.capacity() * sizeof(Value);
+        }
+
+    private:
+        struct Slot {
+            Key key = Key();
+            SlotState state = SlotState::EMPTY;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<Value> values;
+    };
+};
+
+// --- 模板类 `HashMap` ---
+
+template<class Key, class Value, class Layout = InterleavedLayout, class SizePolicy = PrimeSizePolicy>
+class HashMap {
+public:
+    // 构造函数：表长由 SizePolicy 决定（默认取不小于 initialSize 的质数）
+    explicit HashMap(int initialSize = 101) {
+        storage.assign(SizePolicy::nextSize(initialSize));
+    }
+
+    // 查找 key，返回对应 value 的地址，不存在时返回 nullptr
+    // 返回的地址在下一次插入或删除之前有效
+    Value *find(const Key &key) {
+        return const_cast<Value *>(findValue(key));
+    }
+
+    const Value *find(const Key &key) const {
+        return findValue(key);
+    }
+
+    // 异构查找：Key 的哈希函数是透明的时候（例如 Key 为 std::string），可以直接用 string_view、const char * 查找
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    Value *find(const K &key) {
+        return const_cast<Value *>(findValue(key));
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    const Value *find(const K &key) const {
+        return findValue(key);
+    }
+
+    // 检查 key 是否存在
+    bool contains(const Key &key) const {
+        return find(key) != nullptr;
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    bool contains(const K &key) const {
+        return find(key) != nullptr;
+    }
+
+    // 插入键值对，key 已经存在时不覆盖，返回 false
+    bool insert(const Key &key, const Value &value) {
+        bool inserted;
+        int currentPos = insertPos(key, inserted);
+        if (inserted) {
+            storage.value(currentPos) = value;
+        }
+        return inserted;
+    }
+
+    // 插入键值对，key 已经存在时覆盖原来的 value。返回是否是新插入的
+    bool insertOrAssign(const Key &key, const Value &value) {
+        bool inserted;
+        int currentPos = insertPos(key, inserted);
+        storage.value(currentPos) = value;
+        return inserted;
+    }
+
+    // 返回 key 对应 value 的引用，key 不存在时先插入一个默认构造的 value
+    Value &operator[](const Key &key) {
+        bool inserted;
+        int currentPos = insertPos(key, inserted);
+        if (inserted) {
+            storage.value(currentPos) = Value();    // 复用的墓碑里可能还留着旧值
+        }
+        return storage.value(currentPos);
+    }
+
+    // 删除 key（逻辑删除），value 重置为默认值，及时释放它持有的资源
+    bool remove(const Key &key) {
+        return removeAt(findPos(key));
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    bool remove(const K &key) {
+        return removeAt(findPos(key));
+    }
+
+    // 清空
+    void makeEmpty() {
+        storage.assign(storage.size());
+        currentActiveSize = 0;
+        currentDeletedSize = 0;
+    }
+
+    // 获取键值对的数量
+    int size() const {
+        return currentActiveSize;
+    }
+
+    // 获取表长
+    int capacity() const {
+        return storage.size();
+    }
+
+    // 估算占用的内存（字节），不包含 key、value 自己在堆上持有的内存
+    size_t memoryUsage() const {
+        return storage.memoryUsage();
+    }
+
+private:
+    using Storage = typename Layout::template Storage<Key, Value>;
+
+    Storage storage;
+    int currentActiveSize = 0;     // 有效键值对的数量
+    int currentDeletedSize = 0;    // 墓碑的数量
+
+    // find 的实现，非 const 版本的 find 去掉返回值的 const 即可
+    template<class K>
+    const Value *findValue(const K &key) const {
+        int currentPos = findPos(key);
+        return storage.state(currentPos) == SlotState::ACTIVE ? &storage.value(currentPos) : nullptr;
+    }
+
+    // 查找 key 的位置：存在时返回它所在的位置，否则返回探测序列上第一个 EMPTY 的位置
+    // 和 ProbingHash 的 findPos 一样，key 恰好等于某个墓碑里的旧 key 时停在这个墓碑上
+    template<class K>
+    int findPos(const K &key) const {
+        int offset = 1;
+        int currentPos = myHash(key);
+        while (storage.state(currentPos) != SlotState::EMPTY && !(storage.key(currentPos) == key)) {
+            currentPos += offset;
+            offset += SizePolicy::PROBE_STEP;
+            if (currentPos >= storage.size()) {
+                currentPos -= storage.size();
+            }
+        }
+        return currentPos;
+    }
+
+    // 找到（必要时创建）key 所在的槽位，inserted 表示是否是新建的
+    // 如果这次插入会让 活跃 + 墓碑 超过表长的一半，先扩容或清理墓碑，再确定插入位置，
+    // 所以返回的位置在本次调用之后不会再变
+    int insertPos(const Key &key, bool &inserted) {
+        int currentPos = findPos(key);
+        if (storage.state(currentPos) == SlotState::ACTIVE) {
+            inserted = false;
+            return currentPos;
+        }
+
+        if (currentActiveSize + currentDeletedSize + 1 > storage.size() / 2) {
+            // 和 ProbingHash 相同的判断：活跃元素本身就多时扩容，主要是墓碑多时按原表长重建
+            rebuild(currentActiveSize + 1 > storage.size() / 4 ? SizePolicy::nextSize(2 * storage.size()) : storage.size());
+            currentPos = findPos(key);
+        }
+        if (storage.state(currentPos) == SlotState::DELETED) {
+            currentDeletedSize--;
+        }
+        storage.key(currentPos) = key;
+        storage.state(currentPos) = SlotState::ACTIVE;
+        currentActiveSize++;
+        inserted = true;
+        return currentPos;
+    }
+
+    bool removeAt(int currentPos) {
+        if (storage.state(currentPos) != SlotState::ACTIVE) {
+            return false;
+        }
+        storage.state(currentPos) = SlotState::DELETED;
+        storage.value(currentPos) = Value();
+        currentActiveSize--;
+        currentDeletedSize++;
+        return true;
+    }
+
+    // 重建为 newSize 个槽位，只搬活跃的键值对，墓碑全部丢弃
+    void rebuild(int newSize) {
+        Storage oldStorage = std::move(storage);
+        storage = Storage();
+        storage.assign(newSize);
+        currentDeletedSize = 0;
+        for (int i = 0; i < oldStorage.size(); ++i) {
+            if (oldStorage.state(i) == SlotState::ACTIVE) {
+                int currentPos = findPos(oldStorage.key(i));    // 新表中没有重复的 key，一定停在 EMPTY 上
+                storage.key(currentPos) = std::move(oldStorage.key(i));
+                storage.value(currentPos) = std::move(oldStorage.value(i));
+                storage.state(currentPos) = SlotState::ACTIVE;
+            }
+        }
+    }
+
+    // 核心哈希映射函数，Key 的透明哈希保证 K 和对应的 Key 算出相同的哈希值
+    template<class K>
+    int myHash(const K &key) const {
+        size_t hashVal = DefaultHash<Key>{}(key);
+        return static_cast<int>(SizePolicy::index(hashVal, storage.size()));
+    }
+};
+
+// --- 存储布局的性能对比 ---
+
+// 一个比较大的 value：64 字节，一个 cache line 只放得下一个
+struct Record {
+    long long id = 0;
+    std::array<char, 56> payload{};
+};
+
+// 对同一组 key，分别测试：
+//    hit：命中查找并读取 value
+//    miss：不命中的查找
+//    set + map：先查一个只存 key 的集合（ProbingHash 的 HashTable），命中后再去另一张表取 value，即“两遍查找”的做法
+// key 的最低位都是 0，key | 1 一定不在表中
+template<class Map>
+void benchmarkLayout(const char *name, const std::vector<int> &keys, const std::vector<int> &queries) {
+    Map map;
+    for (int k : keys) {
+        map.insert(k, Record{k, {}});
+    }
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int q : queries) {
+        if (const Record *r = map.find(q)) {
+            sum += r->id;
+        }
+    }
+    auto hit = std::chrono::steady_clock::now();
+    int missFound = 0;
+    for (int q : queries) {
+        missFound += map.contains(q | 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "  " << name << ": hit " << std::chrono::duration<double, std::milli>(hit - start).count() << " ms"
+              << ", miss " << std::chrono::duration<double, std::milli>(end - hit).count() << " ms"
+              << ", memory " << map.memoryUsage() / (1024 * 1024) << " MB (checksum " << sum << ", " << missFound << ")" << std::endl;
+}
+
+// --- 主函数测试 ---
+
+int main() {
+    // 1. 基本功能
+    std::cout << "--- Testing HashMap<std::string, int> ---" << std::endl;
+    HashMap<std::string, int> wordCount(7);
+    for (const char *word : {"apple", "banana", "apple", "cherry", "banana", "apple"}) {
+        wordCount[word]++;
+    }
+    std::cout << "apple: " << *wordCount.find("apple") << ", banana: " << *wordCount.find(std::string_view("banana"))
+              << ", cherry: " << wordCount["cherry"] << std::endl;
+    std::cout << "Contains 'grape': " << (wordCount.contains("grape") ? "Yes" : "No") << std::endl;
+    std::cout << "insert('apple', 100): " << (wordCount.insert("apple", 100) ? "inserted" : "kept") << ", apple: " << wordCount["apple"]
+              << std::endl;
+    std::cout << "insertOrAssign('apple', 100): " << (wordCount.insertOrAssign("apple", 100) ? "inserted" : "assigned")
+              << ", apple: " << wordCount["apple"] << std::endl;
+    std::cout << "Removing 'banana': " << (wordCount.remove("banana") ? "OK" : "Not found") << std::endl;
+    std::cout << "Find 'banana': " << (wordCount.find("banana") == nullptr ? "nullptr" : "found") << std::endl;
+    std::cout << "Size: " << wordCount.size() << ", capacity: " << wordCount.capacity() << std::endl;
+
+    // 2. 插入删除交替进行后的正确性：两种布局结果应该完全一致
+    std::cout << "\n--- Churn check (both layouts) ---" << std::endl;
+    HashMap<int, int, InterleavedLayout> interleaved;
+    HashMap<int, int, SplitLayout> split;
+    for (int i = 0; i < 20000; ++i) {
+        interleaved[i % 5000] += i;
+        split[i % 5000] += i;
+        if (i % 3 == 0) {
+            interleaved.remove(i % 7000);
+            split.remove(i % 7000);
+        }
+    }
+    bool ok = interleaved.size() == split.size();
+    for (int i = 0; i < 7000; ++i) {
+        const int *a = interleaved.find(i);
+        const int *b = split.find(i);
+        ok &= (a == nullptr) == (b == nullptr) && (a == nullptr || *a == *b);
+    }
+    std::cout << "Size: " << interleaved.size() << ", layouts agree: " << (ok ? "OK" : "FAILED") << std::endl;
+
+    // 3. 布局对比：value 为 64 字节的 Record
+    std::cout << "\n--- Layout benchmark (64-byte values) ---" << std::endl;
+    const int N = 1 << 19;
+    std::vector<int> keys(N), queries(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        keys[i] = static_cast<int>(seed & 0x7ffffffe);
+    }
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        queries[i] = keys[(seed >> 8) % N];
+    }
+    benchmarkLayout<HashMap<int, Record, InterleavedLayout>>("InterleavedLayout", keys, queries);
+    benchmarkLayout<HashMap<int, Record, SplitLayout>>("SplitLayout      ", keys, queries);
+
+    // 对照：集合 + 另一张存 value 的表，每次命中都要查两遍
+    HashTable<int> keySet;
+    HashMap<int, Record> values;
+    for (int k : keys) {
+        keySet.insert(k);
+        values.insert(k, Record{k, {}});
+    }
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int q : queries) {
+        if (keySet.contains(q)) {
+            sum += values.find(q)->id;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "  set + map        : hit " << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms (checksum " << sum << ")" << std::endl;
+
+    return 0;
+}
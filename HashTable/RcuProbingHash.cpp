@@ -0,0 +1,377 @@
+// 读无锁的哈希表：RCU 风格的快照切换 + 基于纪元（epoch）的内存回收
+// 底层表就是 ProbingHash.cpp 中的平方探测 HashTable
+
+// 对于 99% 都是 contains 的只读缓存，哪怕是分片的读写锁也太贵了：
+// 读锁本身要修改锁里的读者计数，所有读者都在写同一个 cache line，核越多，这个 cache line 来回传递得越厉害
+// RCU（Read-Copy-Update）的思路：
+//    1. 读者：读取当前表的指针，直接在这张表上查找。不加锁，也不写任何共享数据
+//    2. 写者：把当前表完整拷贝一份，在副本上修改，然后用一次原子操作把指针换成新表（发布）
+//    3. 旧表不能立刻 delete，因为可能还有读者正在用它。要等到“所有可能看到旧表的读者都离开了”才能回收
+// 第 3 步用纪元来判断：
+//    - 全局有一个纪元计数器 globalEpoch，每发布一张新表，旧表就记下当时的纪元，然后纪元 + 1
+//    - 每个读者线程有一个自己独占的槽位（单独占一个 cache line），查找前把当前纪元写进去，查找后写回 IDLE
+//    - 旧表的纪元 r 小于所有正在查找的读者登记的纪元时，说明这些读者都是在换表之后才开始的，
+//      它们拿到的一定是新表，旧表可以安全回收
+// 读者只写自己的槽位，所以读操作可以随核数线性扩展
+// 代价是写操作要拷贝整张表（O(n)），只适合读多写少的场景。批量修改可以用 update() 合并成一次拷贝
+
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+
+// --- 纪元管理 ---
+
+// 所有 RcuHashTable 共用一个纪元域，每个线程在其中占一个槽位
+class EpochDomain {
+public:
+    static constexpr int MAX_THREADS = 256;
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max();    // 槽位空闲（线程不在读）
+
+    // 全局唯一的纪元域
+    static EpochDomain &instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // 当前线程的槽位下标，线程第一次读的时候申请，线程退出时自动归还
+    int threadSlot() {
+        thread_local ThreadSlot slot(*this);
+        return slot.index;
+    }
+
+    // 读者进入临界区：把当前纪元登记到自己的槽位
+    // 必须是 seq_cst：登记纪元（写）要先于之后读取表指针（读）被其他线程看到，普通的 release 保证不了“写-读”顺序
+    void enter(int index) {
+        slots[index].epoch.store(globalEpoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    }
+
+    // 读者离开临界区
+    void exit(int index) {
+        slots[index].epoch.store(IDLE, std::memory_order_release);
+    }
+
+    // 推进纪元，返回推进之前的纪元
+    uint64_t advance() {
+        return globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // 所有正在读的线程中，最小的登记纪元。没有读者时返回 IDLE
+    uint64_t minActiveEpoch() const {
+        uint64_t result = IDLE;
+        for (int i = 0; i < MAX_THREADS; ++i) {
+            result = std::min(result, slots[i].epoch.load(std::memory_order_seq_cst));
+        }
+        return result;
+    }
+
+private:
+    // 每个槽位独占一个 cache line，读者之间不会互相干扰
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> used{false};
+    };
+
+    // 线程私有的槽位句柄，thread_local 对象在线程结束时析构，借此归还槽位
+    struct ThreadSlot {
+        EpochDomain &domain;
+        int index;
+
+        explicit ThreadSlot(EpochDomain &d) : domain(d), index(-1) {
+            for (int i = 0; i < MAX_THREADS; ++i) {
+                bool expected = false;
+                if (domain.slots[i].used.compare_exchange_strong(expected, true)) {
+                    index = i;
+                    return;
+                }
+            }
+            throw std::runtime_error("EpochDomain: too many reader threads.");
+        }
+
+        ~ThreadSlot() {
+            domain.slots[index].epoch.store(IDLE, std::memory_order_release);
+            domain.slots[index].used.store(false, std::memory_order_release);
+        }
+    };
+
+    alignas(64) std::atomic<uint64_t> globalEpoch{1};
+    Slot slots[MAX_THREADS];
+};
+
+// 读者临界区的 RAII 封装，构造时 enter，析构时 exit
+class EpochGuard {
+public:
+    EpochGuard() : domain(EpochDomain::instance()), index(domain.threadSlot()) {
+        domain.enter(index);
+    }
+
+    ~EpochGuard() {
+        domain.exit(index);
+    }
+
+private:
+    EpochDomain &domain;
+    int index;
+};
+
+// --- 模板类 `RcuHashTable` ---
+
+template<class HashedObj, class SizePolicy = PrimeSizePolicy>
+class RcuHashTable {
+public:
+    using Table = HashTable<HashedObj, SizePolicy>;
+
+    explicit RcuHashTable(int initialSize = 101) : current(new Table(initialSize)) {}
+
+    // 析构时不应再有读者，直接释放当前表和所有待回收的旧表
+    ~RcuHashTable() {
+        delete current.load();
+        for (auto &retired : retiredTables) {
+            delete retired.second;
+        }
+    }
+
+    RcuHashTable(const RcuHashTable &) = delete;
+    RcuHashTable &operator=(const RcuHashTable &) = delete;
+
+    // 检查元素是否存在：不加锁，只写本线程的纪元槽位
+    bool contains(const HashedObj &x) const {
+        EpochGuard guard;
+        return current.load(std::memory_order_seq_cst)->contains(x);
+    }
+
+    // 获取当前快照中的元素数量
+    int size() const {
+        EpochGuard guard;
+        return current.load(std::memory_order_seq_cst)->size();
+    }
+
+    // 插入元素：已经存在时不拷贝，直接返回 false
+    bool insert(const HashedObj &x) {
+        bool inserted = false;
+        update([&x, &inserted](Table &table) {
+            inserted = table.insert(x);
+        }, [&x](const Table &table) {
+            return !table.contains(x);
+        });
+        return inserted;
+    }
+
+    // 删除元素：不存在时不拷贝，直接返回 false
+    bool remove(const HashedObj &x) {
+        bool removed = false;
+        update([&x, &removed](Table &table) {
+            removed = table.remove(x);
+        }, [&x](const Table &table) {
+            return table.contains(x);
+        });
+        return removed;
+    }
+
+    // 批量修改：拷贝一次当前表，在副本上执行 modify，再整体发布
+    // 一次 update 中做多次修改，只付出一次拷贝的代价，读者看到的要么全是旧的，要么全是新的
+    template<class Modify>
+    void update(Modify modify) {
+        update(modify, [](const Table &) {
+            return true;
+        });
+    }
+
+    // 待回收（已经被替换、但还没有释放）的旧表数量
+    int retiredCount() const {
+        std::lock_guard<std::mutex> guard(writerLock);
+        return static_cast<int>(retiredTables.size());
+    }
+
+private:
+    std::atomic<Table *> current;                                  // 当前发布的快照，读者只读它
+    mutable std::mutex writerLock;                                 // 写者之间互斥，读者不碰这把锁
+    std::vector<std::pair<uint64_t, Table *>> retiredTables;       // (退休纪元, 旧表)
+
+    // needCopy 在写锁内、拷贝之前判断这次修改是否真的需要进行
+    template<class Modify, class Predicate>
+    void update(Modify modify, Predicate needCopy) {
+        std::lock_guard<std::mutex> guard(writerLock);
+        Table *oldTable = current.load(std::memory_order_relaxed);    // 写者持锁，当前表不会被别人换掉
+        if (!needCopy(*oldTable)) {
+            return;
+        }
+
+        Table *newTable = new Table(*oldTable);    // Read-Copy
+        modify(*newTable);                          // Update
+        current.store(newTable, std::memory_order_seq_cst);
+
+        // 先发布新表，再推进纪元：纪元推进之后才开始的读者，一定能看到新表
+        retiredTables.emplace_back(EpochDomain::instance().advance(), oldTable);
+        reclaim();
+    }
+
+    // 回收所有已经没有读者可能在使用的旧表
+    void reclaim() {
+        uint64_t minEpoch = EpochDomain::instance().minActiveEpoch();
+        size_t kept = 0;
+        for (auto &retired : retiredTables) {
+            if (retired.first < minEpoch) {
+                delete retired.second;
+            } else {
+                retiredTables[kept++] = retired;
+            }
+        }
+        retiredTables.resize(kept);
+    }
+};
+
+// --- 对照组：读写锁保护的 HashTable ---
+
+template<class HashedObj>
+class RwLockedHashTable {
+public:
+    bool contains(const HashedObj &x) const {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        return table.contains(x);
+    }
+
+    bool insert(const HashedObj &x) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        return table.insert(x);
+    }
+
+    bool remove(const HashedObj &x) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        return table.remove(x);
+    }
+
+private:
+    mutable std::shared_mutex lock;
+    HashTable<HashedObj> table;
+};
+
+// --- 读扩展性测试 ---
+
+// readers 个线程不停地 contains，另有 1 个写者线程每隔 writeIntervalUs 微秒做一次 insert 或 remove
+// 返回读吞吐量（百万次操作/秒）
+template<class Table>
+double runReadMostly(Table &table, int readers, int readsPerThread, int writeIntervalUs) {
+    const int KEY_RANGE = 1 << 14;
+    std::atomic<bool> go(false), stop(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+        threads.emplace_back([&table, &go, t, readsPerThread]() {
+            unsigned seed = 2463534242u * (t + 1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            int hits = 0;
+            for (int i = 0; i < readsPerThread; ++i) {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                hits += table.contains(static_cast<int>(seed % KEY_RANGE));
+            }
+            volatile int sink = hits;    // 防止查找被优化掉
+            (void)sink;
+        });
+    }
+    std::thread writer([&table, &go, &stop, writeIntervalUs]() {
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; !stop.load(std::memory_order_acquire); ++i) {
+            int key = (i * 7919) % KEY_RANGE;
+            if (!table.insert(key)) {
+                table.remove(key);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(writeIntervalUs));
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    stop.store(true, std::memory_order_release);
+    writer.join();
+    return static_cast<double>(readers) * readsPerThread / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+// --- 主函数测试 ---
+
+int main(int argc, char *argv[]) {
+    // 1. 基本功能
+    std::cout << "--- Testing RcuHashTable ---" << std::endl;
+    RcuHashTable<int> table(7);
+    for (int x : {10, 21, 32, 13, 44}) {
+        table.insert(x);
+    }
+    std::cout << "Contains 21: " << (table.contains(21) ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 99: " << (table.contains(99) ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 21: " << (table.remove(21) ? "OK" : "Not found") << std::endl;
+    std::cout << "Contains 21: " << (table.contains(21) ? "Yes" : "No") << std::endl;
+
+    // 批量修改只拷贝一次
+    table.update([](HashTable<int> &t) {
+        for (int x = 100; x < 200; ++x) {
+            t.insert(x);
+        }
+    });
+    std::cout << "Size after batch update: " << table.size() << std::endl;
+    // 没有读者时，旧表在下一次发布时就会被回收
+    std::cout << "Retired (not yet reclaimed) tables: " << table.retiredCount() << std::endl;
+
+    // 2. 并发正确性：写者不断插入删除奇数，读者检查偶数始终存在、且读到的快照是完整的
+    std::cout << "\n--- Concurrent readers check ---" << std::endl;
+    RcuHashTable<int> shared;
+    shared.update([](HashTable<int> &t) {
+        for (int x = 0; x < 1000; x += 2) {
+            t.insert(x);
+        }
+    });
+    std::atomic<bool> stop(false), ok(true);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&shared, &stop, &ok]() {
+            while (!stop.load()) {
+                for (int x = 0; x < 1000; x += 2) {
+                    if (!shared.contains(x)) {
+                        ok = false;
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 2000; ++i) {
+        shared.insert(2 * (i % 500) + 1);
+        shared.remove(2 * ((i + 250) % 500) + 1);
+    }
+    stop = true;
+    for (auto &r : readers) {
+        r.join();
+    }
+    std::cout << "Readers always saw even keys: " << (ok ? "OK" : "FAILED") << std::endl;
+
+    // 3. 读扩展性：RCU vs 读写锁，读者线程数 1 ~ maxThreads，写者每 100 微秒写一次
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 16;
+    int readsPerThread = argc > 2 ? std::atoi(argv[2]) : 200000;
+    std::cout << "\n--- Read scaling benchmark (hardware threads: " << std::thread::hardware_concurrency() << ") ---" << std::endl;
+    RcuHashTable<int> rcuTable;
+    RwLockedHashTable<int> rwTable;
+    for (int k = 0; k < (1 << 14); k += 2) {
+        rcuTable.insert(k);
+        rwTable.insert(k);
+    }
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double rcu = runReadMostly(rcuTable, threads, readsPerThread, 100);
+        double rw = runReadMostly(rwTable, threads, readsPerThread, 100);
+        std::cout << "  " << threads << " readers: RCU " << rcu << " Mops/s, shared_mutex " << rw << " Mops/s" << std::endl;
+    }
+
+    return 0;
+}
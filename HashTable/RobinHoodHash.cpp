@@ -0,0 +1,338 @@
+// 开放寻址法——Robin Hood 线性探测 + 后移删除（backward-shift deletion）的哈希表实现
+// 公开接口与 ProbingHash.cpp 中的平方探测 HashTable 相同，可以直接替换
+
+// 平方探测的两个问题：
+//    1. 装填因子必须不超过 0.5，否则不保证能找到空位，一半的空间是空着的
+//    2. 删除只能打墓碑，墓碑会拉长探测序列，需要定期清理
+// 而且探测长度的方差很大：大部分元素一次命中，少数“倒霉”的元素要探测几十次
+// Robin Hood（劫富济贫）的思路：
+//    每个元素记录自己离哈希位置的距离 dist（probe sequence length）
+//    插入时沿线性探测往后走，如果遇到一个 dist 比“正在安置的元素”小的元素（它更“富”），
+//    就把位置抢过来，让被挤出来的那个元素继续往后找位置
+//    结果是同一段连续区域里，元素按哈希位置有序排列，每个元素的 dist 都差不多，最长探测长度被压得很低
+// 查找可以提前终止：走到第 d 步时，如果当前槽位的 dist < d，说明要找的元素如果存在，早就应该抢占这里了
+// 删除不需要墓碑（后移删除）：
+//    删掉位置 i 的元素后，把后面 dist > 0 的元素逐个往前挪一格（dist 减 1），直到遇到空位或 dist == 0 的元素
+//    这样表里始终不存在“空洞”，查找的提前终止条件依然成立
+// 探测长度的方差小、没有墓碑，装填因子可以放到 0.9，空间利用率比平方探测高得多（平均探测长度会随装填因子变长，见 main 中的对比）
+// 线性探测对 cache 也更友好：一次查找访问的是连续的内存
+
+#define PROBING_HASH_NO_MAIN
+#include "ProbingHash.cpp"
+
+#include <utility>
+
+// --- 模板类 `RobinHoodHashTable` ---
+
+// SizePolicy 只用到 nextSize 和 index，线性探测对表长没有要求，PROBE_STEP 用不到
+// 默认用 2 的幂表长：回绕只需要一次比较，配合混合函数，连续的 key 也不会挤在一起
+template<class HashedObj, class SizePolicy = PowerOfTwoSizePolicy>
+class RobinHoodHashTable {
+public:
+    // 哈希表的槽位结构：dist 为 EMPTY 表示空槽位，否则是元素离哈希位置的距离
+    struct HashEntry {
+        static constexpr int EMPTY = -1;
+
+        HashedObj element;
+        int dist;
+
+        HashEntry(const HashedObj &e = HashedObj(), int d = EMPTY) : element(e), dist(d) {}
+    };
+
+    // 探测统计信息，字段含义与 ProbingHash 的 ProbeStats 相同，Robin Hood 没有墓碑
+    struct ProbeStats {
+        int activeCount;               // 元素数量
+        int capacity;                  // 表长
+        double loadFactor;             // 装填因子 = 元素数量 / 表长
+        double avgSuccessfulProbe;     // ASL(success)：查找每个元素所需探测次数的平均值
+        int maxSuccessfulProbe;        // 最长的成功查找探测次数
+        double avgUnsuccessfulProbe;   // ASL(failure)：从每个位置出发，直到提前终止的探测次数平均值
+        int rehashCount;               // 扩容 rehash 的次数
+    };
+
+    // 构造函数：maxLoadFactor 是触发扩容的装填因子
+    explicit RobinHoodHashTable(int initialSize = 101, double maxLoadFactor = 0.9)
+        : array(SizePolicy::nextSize(initialSize)), maxLoad(maxLoadFactor) {
+        makeEmpty();
+    }
+
+    // 检查元素是否存在
+    bool contains(const HashedObj &x) const {
+        return findPos(x) != -1;
+    }
+
+    // 清空哈希表
+    void makeEmpty() {
+        currentSize = 0;
+        for (auto &entry : array) {
+            entry.dist = HashEntry::EMPTY;
+        }
+    }
+
+    // 插入元素
+    bool insert(const HashedObj &x) {
+        if (findPos(x) != -1) {
+            return false;
+        }
+        // 先扩容再插入，保证表里永远至少有一个空位，下面的循环一定会停
+        if (currentSize + 1 > maxLoad * array.size()) {
+            rehash();
+        }
+        place(x);
+        return true;
+    }
+
+    // 删除元素（后移删除，不留墓碑）
+    bool remove(const HashedObj &x) {
+        int currentPos = findPos(x);
+        if (currentPos == -1) {
+            return false;
+        }
+
+        // 把后面“离家”的元素逐个往前挪，直到遇到空位或者本来就在哈希位置上的元素
+        int nextPos = advance(currentPos);
+        while (array[nextPos].dist > 0) {
+            array[currentPos].element = std::move(array[nextPos].element);
+            array[currentPos].dist = array[nextPos].dist - 1;
+            currentPos = nextPos;
+            nextPos = advance(nextPos);
+        }
+        array[currentPos].dist = HashEntry::EMPTY;
+        currentSize--;
+        return true;
+    }
+
+    // 获取当前元素的数量
+    int size() const {
+        return currentSize;
+    }
+
+    // 获取哈希表的总容量
+    int capacity() const {
+        return array.size();
+    }
+
+    // 统计探测长度等信息，只用于观察，不要放在热路径上
+    // 每个槽位里存着 dist，成功查找的探测次数就是 dist + 1，不需要重新走探测序列
+    ProbeStats probeStats() const {
+        ProbeStats stats;
+        stats.activeCount = currentSize;
+        stats.capacity = array.size();
+        stats.loadFactor = static_cast<double>(currentSize) / array.size();
+        stats.rehashCount = rehashCount;
+
+        long long totalSuccess = 0;
+        stats.maxSuccessfulProbe = 0;
+        for (const auto &entry : array) {
+            if (entry.dist != HashEntry::EMPTY) {
+                totalSuccess += entry.dist + 1;
+                stats.maxSuccessfulProbe = std::max(stats.maxSuccessfulProbe, entry.dist + 1);
+            }
+        }
+        stats.avgSuccessfulProbe = currentSize == 0 ? 0.0 : static_cast<double>(totalSuccess) / currentSize;
+
+        // 不成功查找：从每个位置出发，走到 dist 小于已走步数（包括空位）为止
+        long long totalFailure = 0;
+        for (int i = 0; i < array.size(); ++i) {
+            int currentPos = i;
+            int d = 0;
+            while (array[currentPos].dist >= d) {
+                currentPos = advance(currentPos);
+                d++;
+            }
+            totalFailure += d + 1;
+        }
+        stats.avgUnsuccessfulProbe = static_cast<double>(totalFailure) / array.size();
+        return stats;
+    }
+
+    // 打印哈希表内容（用于调试），括号里是离哈希位置的距离
+    void printHashTable() const {
+        std::cout << "--- Robin Hood Hash Table Contents (Size: " << currentSize << ", Capacity: " << array.size()
+                  << ") ---" << std::endl;
+        for (int i = 0; i < array.size(); ++i) {
+            std::cout << "Bucket " << i << ": ";
+            if (array[i].dist != HashEntry::EMPTY) {
+                std::cout << array[i].element << " (dist " << array[i].dist << ")";
+            } else {
+                std::cout << " (EMPTY)";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "---------------------------------------------------" << std::endl;
+    }
+
+private:
+    std::vector<HashEntry> array;    // 存储哈希表槽位的vector
+    int currentSize;                 // 当前元素的数量
+    double maxLoad;                  // 触发扩容的装填因子
+    int rehashCount = 0;             // 扩容次数，仅用于统计
+
+    // 线性探测的下一个位置
+    int advance(int currentPos) const {
+        return currentPos + 1 == static_cast<int>(array.size()) ? 0 : currentPos + 1;
+    }
+
+    // 查找元素 x 的位置，不存在时返回 -1
+    // 第 d 步遇到的槽位 dist < d（空位的 dist 是 -1，也满足）时提前终止
+    int findPos(const HashedObj &x) const {
+        int currentPos = myHash(x);
+        for (int d = 0; array[currentPos].dist >= d; ++d) {
+            if (array[currentPos].dist == d && array[currentPos].element == x) {
+                return currentPos;
+            }
+            currentPos = advance(currentPos);
+        }
+        return -1;
+    }
+
+    // 安置一个确定不在表中的元素：遇到更“富”的元素就和它交换，让它继续往后找位置
+    void place(HashedObj x) {
+        int currentPos = myHash(x);
+        int d = 0;
+        while (array[currentPos].dist != HashEntry::EMPTY) {
+            if (array[currentPos].dist < d) {
+                std::swap(x, array[currentPos].element);
+                std::swap(d, array[currentPos].dist);
+            }
+            currentPos = advance(currentPos);
+            d++;
+        }
+        array[currentPos].element = std::move(x);
+        array[currentPos].dist = d;
+        currentSize++;
+    }
+
+    // 再散列函数：表长翻倍，所有元素重新安置
+    void rehash() {
+        std::vector<HashEntry> oldArray = std::move(array);
+        array.assign(SizePolicy::nextSize(2 * oldArray.size()), HashEntry());
+        currentSize = 0;
+        rehashCount++;
+        for (auto &entry : oldArray) {
+            if (entry.dist != HashEntry::EMPTY) {
+                place(std::move(entry.element));
+            }
+        }
+    }
+
+    // 核心哈希映射函数，由 SizePolicy 把哈希值映射到 [0, array.size() - 1]
+    int myHash(const HashedObj &x) const {
+        size_t hashVal = std::hash<HashedObj>{}(x);
+        return static_cast<int>(SizePolicy::index(hashVal, array.size()));
+    }
+};
+
+// --- Robin Hood 与平方探测的对比 ---
+
+// 在同一组 key 上测一张表：先插入，再做同样数量的命中查找和不命中查找
+// 两种表的 ProbeStats 结构不同，但都有这里用到的几个字段
+// key 的最低位都是 0，key | 1 一定不在表中
+template<class Table>
+void benchmarkTable(const char *name, Table &table, const std::vector<int> &keys) {
+    for (int k : keys) {
+        table.insert(k);
+    }
+    auto start = std::chrono::steady_clock::now();
+    int found = 0;
+    for (int k : keys) {
+        found += table.contains(k);
+    }
+    auto hit = std::chrono::steady_clock::now();
+    for (int k : keys) {
+        found += table.contains(k | 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto stats = table.probeStats();
+    double hitMs = std::chrono::duration<double, std::milli>(hit - start).count();
+    double missMs = std::chrono::duration<double, std::milli>(end - hit).count();
+    std::cout << "  " << name << ": load " << stats.loadFactor << ", ASL(success) " << stats.avgSuccessfulProbe
+              << ", max " << stats.maxSuccessfulProbe << ", ASL(failure) " << stats.avgUnsuccessfulProbe
+              << ", hit " << hitMs << " ms, miss " << missMs << " ms, found " << found << std::endl;
+}
+
+// --- 主函数测试 ---
+
+int main() {
+    // 1. 基本功能
+    std::cout << "--- Testing RobinHoodHashTable with int ---" << std::endl;
+    RobinHoodHashTable<int> intHashTable(8);
+    for (int x : {10, 21, 32, 13, 44, 55}) {
+        intHashTable.insert(x);
+    }
+    intHashTable.printHashTable();
+    std::cout << "Contains 21: " << (intHashTable.contains(21) ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 99: " << (intHashTable.contains(99) ? "Yes" : "No") << std::endl;
+
+    std::cout << "\nRemoving 13 (later entries shift back)..." << std::endl;
+    intHashTable.remove(13);
+    intHashTable.printHashTable();
+    std::cout << "Contains 13: " << (intHashTable.contains(13) ? "Yes" : "No") << std::endl;
+
+    std::cout << "\n--- Testing RobinHoodHashTable with string ---" << std::endl;
+    RobinHoodHashTable<std::string> stringHashTable(8);
+    for (const char *s : {"apple", "banana", "cherry", "date", "elderberry", "fig"}) {
+        stringHashTable.insert(s);
+    }
+    stringHashTable.remove("cherry");
+    std::cout << "Contains 'banana': " << (stringHashTable.contains("banana") ? "Yes" : "No") << std::endl;
+    std::cout << "Contains 'cherry': " << (stringHashTable.contains("cherry") ? "Yes" : "No") << std::endl;
+    std::cout << "Size: " << stringHashTable.size() << std::endl;
+
+    // 2. churn：没有墓碑，反复插入删除后探测长度不会变长
+    std::cout << "\n--- Churn test at high load ---" << std::endl;
+    RobinHoodHashTable<int> churnTable(1024);
+    for (int i = 0; i < 900; ++i) {
+        churnTable.insert(i);
+    }
+    for (int round = 0; round <= 5; ++round) {
+        if (round > 0) {
+            for (int i = 0; i < 400; ++i) {
+                int oldest = (round - 1) * 400 + i;
+                churnTable.remove(oldest);
+                churnTable.insert(oldest + 900);
+            }
+        }
+        auto s = churnTable.probeStats();
+        std::cout << "Round " << round << ": size=" << s.activeCount << " capacity=" << s.capacity << " load=" << s.loadFactor
+                  << " ASL(success)=" << s.avgSuccessfulProbe << " max=" << s.maxSuccessfulProbe
+                  << " ASL(failure)=" << s.avgUnsuccessfulProbe << std::endl;
+    }
+    bool churnOk = churnTable.size() == 900 && !churnTable.contains(1999);
+    for (int i = 2000; i < 2900; ++i) {
+        churnOk &= churnTable.contains(i);
+    }
+    std::cout << "Churn contents check: " << (churnOk ? "OK" : "FAILED") << std::endl;
+
+    // 3. 探测长度与查找吞吐量：平方探测（装填因子最多 0.5） vs Robin Hood（装填因子 0.9）
+    // 平方探测测两种表长：仓库默认的素数表长（取模），和与 Robin Hood 相同的 2 的幂表长（位与）
+    // 素数表长扩容到“大于两倍的素数”，这里停在装填因子约 0.26，比另外几组都低；连续的 key 对素数取模也不会冲突
+    // Robin Hood 预先开好 2^20 个槽位，插入 0.89 * 2^20 个元素，正好停在扩容阈值之下
+    // 平方探测插入同样多的元素，会自己扩容到装填因子 0.5 以下，所以再加一组同样 2 倍表长的 Robin Hood 作为同装填因子的对照
+    // 装填因子 0.9 时线性探测的平均探测长度本来就会变长（理论值约 (1 + 1/(1-α)) / 2），Robin Hood 换来的是用一半的内存、
+    // 并且没有墓碑；同装填因子下它的最长探测长度比平方探测更短
+    std::cout << "\n--- Robin Hood vs quadratic probing ---" << std::endl;
+    const int CAPACITY = 1 << 20;
+    const int N = static_cast<int>(CAPACITY * 0.89);
+    std::vector<int> sequentialKeys(N), randomKeys(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        sequentialKeys[i] = 2 * i;
+        seed = seed * 1664525u + 1013904223u;
+        randomKeys[i] = static_cast<int>(seed & 0x7ffffffe);
+    }
+    for (auto *keys : {&sequentialKeys, &randomKeys}) {
+        std::cout << (keys == &sequentialKeys ? "Sequential keys:" : "Random keys:") << std::endl;
+        HashTable<int> quadraticPrime;
+        benchmarkTable("Quadratic (prime)", quadraticPrime, *keys);
+        HashTable<int, PowerOfTwoSizePolicy> quadratic;
+        benchmarkTable("Quadratic (pow2) ", quadratic, *keys);
+        RobinHoodHashTable<int> robinHoodSameLoad(2 * CAPACITY);
+        benchmarkTable("Robin Hood (0.45)", robinHoodSameLoad, *keys);
+        RobinHoodHashTable<int> robinHood(CAPACITY);
+        benchmarkTable("Robin Hood (0.9) ", robinHood, *keys);
+    }
+
+    return 0;
+}
@@ -1,10 +1,39 @@
 // 分离链接法的哈希表实现
 
+// 渐进式（增量）rehash：
+// 普通的 rehash 在某一次 insert 中一口气把所有元素搬到新表，表很大时这一次 insert 会停顿很久
+// 渐进式 rehash 则让新旧两个桶数组同时存在，之后每次 insert/remove/contains 顺手搬几个旧桶，
+// 把一次 O(n) 的停顿摊到之后的 O(n) 次操作上（Redis 的 dict 就是这么做的）
+// 迁移期间，旧桶中下标小于 migratePos 的已经搬完，查找时：
+//    1. 先查新表
+//    2. 如果元素在旧表中对应的桶还没搬（下标 >= migratePos），再查旧表
+// 新元素一律插入新表
+
+// 桶的存储：
+// 最直接的写法是 std::vector<std::list<HashedObj>>，但 std::list 每个元素都要单独 new 一个结点，
+// 结点里还有前后两个指针，而且结点散落在堆的各处，查找时几乎每走一步都是一次 cache miss
+// 而负载因子不超过 1 时，绝大多数桶只有 0~3 个元素
+// 所以这里每个桶自带一个很短的内联数组，前几个元素直接放在桶数组里；放满之后才溢出到单链表上
+// 溢出链表的结点不直接 new，而是从哈希表自己持有的结点池（NodePool）里取：
+// 结点池一次申请一整块（slab），用完的结点挂在空闲链表上复用，rehash 时只需要把结点重新挂到新桶上
+
+// 布隆过滤器（可选，enableBloomFilter 打开）：
+// 大部分 contains 都不命中时，每次不命中仍然要读一个随机的桶，还可能顺着溢出链表走几个结点
+// 布隆过滤器用很少的内存（每个元素 10 个 bit 左右）回答“一定不在”或者“可能在”，回答“一定不在”时根本不用碰桶
+// 这里用的是分块（blocked）布隆过滤器：一个元素的所有 bit 都落在同一个 64 字节的块里，一次查询只访问一个 cache line
+// 布隆过滤器不支持删除，remove 之后元素的 bit 还留着（只会多一些假阳性，不会漏判），所以：
+//    1. rehash 时按新的桶数建一个新的过滤器，旧元素在迁移到新桶时加进去，迁移期间新旧两个过滤器都要查
+//    2. 删除的元素累计超过当前元素数量时，按当前元素重建一次，均摊下来每次删除仍是 O(1)
+
 #include <algorithm>     // 包含 std::find
+#include <chrono>
+#include <cstdint>
 #include <functional>    // 包含 std::hash
 #include <iostream>
-#include <list>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 // --- 全局辅助函数 ---
@@ -41,77 +70,448 @@ int nextPrime(int n) {
     return n;
 }
 
-// --- 模板类 `HashTable` ---
+// --- 哈希函数 ---
+
+// 表通过模板参数 Hash 计算哈希值，默认是 DefaultHash，一般类型就是 std::hash
+// 注意 libstdc++ 的 std::hash<int> 是恒等函数，连续或等间隔的整数 key 直接取模时分布很差，
+// 这时可以换成 HashFunctions.cpp 里的哈希函数（例如 FibonacciHash），对比见 HashFunctionBench.cpp
+template<class T>
+struct DefaultHash {
+    size_t operator()(const T &x) const {
+        return std::hash<T>{}(x);
+    }
+};
+
+// std::string 的透明（transparent）哈希：
+// 用 string_view 计算哈希值，string、string_view、const char * 都能直接传进来，而且算出的哈希值相同
+// （标准保证 std::hash<std::string> 和 std::hash<std::string_view> 对相同内容给出相同的结果）
+// 定义了 is_transparent，表就允许用 HashedObj 以外的类型查找，查找时不必先构造一个临时的 std::string
+template<>
+struct DefaultHash<std::string> {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view s) const {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+// --- 容量策略 ---
+
+// 表长怎么取、哈希值怎么映射到下标，是一对绑定在一起的选择，这里把它抽成模板参数 SizePolicy
+// 1. PrimeSizePolicy：表长取质数，下标 = hash % 表长（就是文件开头介绍的除留余数法）
+//    质数表长能“打散”质量一般的哈希值，但 64 位取模是一条很慢的除法指令，每次操作都要做一次
+// 2. PowerOfTwoSizePolicy：表长取 2 的幂，下标 = mix(hash) & (表长 - 1)
+//    位与只取低位，而 std::hash<int> 是恒等函数，低位规律性很强，所以必须先用一个混合函数把高位的信息搅到低位
+// 3. FastRangeSizePolicy：Lemire 的 fastrange，下标 = (mix(hash) 的高 32 位 * 表长) >> 32
+//    用一次乘法和移位把 [0, 2^32) 等比例缩放到 [0, 表长)，对表长没有要求，也不需要除法
+// nextPrime 的试除只在 rehash 时调用一次，真正的热点是每次操作都要做的取模
+
+// 辅助函数：64 位混合函数（MurmurHash3 的 fmix64）
+// 输入的每一位都会影响输出的每一位，连续的整数经过混合后也会均匀分布
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 分离链接法不需要考虑探测序列，任何表长都可以
+struct PrimeSizePolicy {
+    static int nextSize(int n) {
+        return nextPrime(n);
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return hashVal % size;
+    }
+};
 
+struct PowerOfTwoSizePolicy {
+    static int nextSize(int n) {
+        int size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return mixHash(hashVal) & (size - 1);
+    }
+};
+
+// fastrange 对表长没有任何要求，直接使用请求的大小
+struct FastRangeSizePolicy {
+    static int nextSize(int n) {
+        return n;
+    }
+
+    static size_t index(size_t hashVal, size_t size) {
+        return static_cast<size_t>(((mixHash(hashVal) >> 32) * static_cast<uint64_t>(size)) >> 32);
+    }
+};
+
+// rehash 的方式
+enum class RehashMode {
+    ALL_AT_ONCE,    // 一次性搬完所有元素
+    INCREMENTAL     // 渐进式，每次操作搬几个桶
+};
+
+// --- 结点池 ---
+
+// 溢出链表的结点
 template<class HashedObj>
+struct ChainNode {
+    HashedObj element;
+    ChainNode *next = nullptr;
+};
+
+// 结点池：按块（slab）批量申请结点，释放的结点挂在空闲链表上，下次直接复用
+// 整个池随哈希表一起销毁，不需要逐个 delete 结点
+template<class HashedObj>
+class NodePool {
+public:
+    NodePool() : freeList(nullptr), nodeCount(0) {}
+
+    // 从空闲链表头部取一个结点，空闲链表为空时先申请一个新的块
+    ChainNode<HashedObj> *allocate() {
+        if (freeList == nullptr) {
+            grow();
+        }
+        ChainNode<HashedObj> *node = freeList;
+        freeList = node->next;
+        node->next = nullptr;
+        return node;
+    }
+
+    // 归还结点：头插到空闲链表
+    // 元素重置为默认值，及时释放 string 这类元素自己持有的内存
+    void deallocate(ChainNode<HashedObj> *node) {
+        node->element = HashedObj();
+        node->next = freeList;
+        freeList = node;
+    }
+
+    // 一次性释放所有块
+    void clear() {
+        slabs.clear();
+        freeList = nullptr;
+        nodeCount = 0;
+    }
+
+    // 池中结点总数（含空闲结点）
+    size_t capacity() const {
+        return nodeCount;
+    }
+
+private:
+    static constexpr size_t SLAB_SIZE = 256;    // 每块的结点数
+
+    std::vector<std::unique_ptr<ChainNode<HashedObj>[]>> slabs;    // 所有申请过的块
+    ChainNode<HashedObj> *freeList;                                // 空闲结点链表
+    size_t nodeCount;
+
+    void grow() {
+        slabs.emplace_back(new ChainNode<HashedObj>[SLAB_SIZE]);
+        ChainNode<HashedObj> *slab = slabs.back().get();
+        // 块内的结点依次串起来，挂到空闲链表上
+        for (size_t i = 0; i < SLAB_SIZE; ++i) {
+            slab[i].next = (i + 1 < SLAB_SIZE) ? &slab[i + 1] : freeList;
+        }
+        freeList = slab;
+        nodeCount += SLAB_SIZE;
+    }
+};
+
+// --- 分块布隆过滤器 ---
+
+// 每个块 512 bit（一个 cache line），每个元素在一个块里设置 HASHES 个 bit
+// 元素的 64 位哈希值：高 32 位选块（fastrange），再乘一个奇数常量，从乘积的高位依次取 9 bit 作为块内的位置
+class BlockedBloomFilter {
+public:
+    static constexpr int BITS_PER_BLOCK = 512;
+    static constexpr int HASHES = 6;
+
+    BlockedBloomFilter() = default;
+
+    // 按预计的元素个数和每个元素分到的 bit 数确定块数
+    BlockedBloomFilter(size_t expectedElements, int bitsPerElement) {
+        size_t blockCount = (expectedElements * bitsPerElement + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK;
+        blocks.assign(std::max<size_t>(1, blockCount), Block());
+    }
+
+    void add(uint64_t h) {
+        Block &block = blocks[blockIndex(h)];
+        uint64_t bits = h * 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < HASHES; ++i) {
+            unsigned pos = static_cast<unsigned>(bits >> (64 - 9 * (i + 1))) & (BITS_PER_BLOCK - 1);
+            block.words[pos >> 6] |= 1ULL << (pos & 63);
+        }
+    }
+
+    // 返回 false 表示一定不在，true 表示可能在
+    bool mayContain(uint64_t h) const {
+        const Block &block = blocks[blockIndex(h)];
+        uint64_t bits = h * 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < HASHES; ++i) {
+            unsigned pos = static_cast<unsigned>(bits >> (64 - 9 * (i + 1))) & (BITS_PER_BLOCK - 1);
+            if (!(block.words[pos >> 6] & (1ULL << (pos & 63)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 清零所有 bit，块数不变
+    void clear() {
+        std::fill(blocks.begin(), blocks.end(), Block());
+    }
+
+    // 释放内存，之后 empty() 为 true
+    void release() {
+        std::vector<Block>().swap(blocks);
+    }
+
+    bool empty() const {
+        return blocks.empty();
+    }
+
+    size_t memoryUsage() const {
+        return blocks.capacity() * sizeof(Block);
+    }
+
+private:
+    struct alignas(64) Block {
+        uint64_t words[BITS_PER_BLOCK / 64] = {};
+    };
+
+    std::vector<Block> blocks;
+
+    size_t blockIndex(uint64_t h) const {
+        return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(blocks.size())) >> 32);
+    }
+};
+
+// --- 模板类 `HashTable` ---
+
+template<class HashedObj, class SizePolicy = PrimeSizePolicy, class Hash = DefaultHash<HashedObj>>
 class HashTable {
 public:
+    // 布隆过滤器的统计信息
+    struct BloomFilterStats {
+        size_t memoryBytes;             // 过滤器占用的内存（迁移期间包括旧过滤器）
+        double bitsPerElement;          // 平均每个元素占多少 bit
+        long long negatives;            // 过滤器直接回答“不在”的查找次数（没有碰桶）
+        long long falsePositives;       // 过滤器回答“可能在”，查桶后发现并不在的次数
+        double falsePositiveRate;       // 假阳性率 = falsePositives / 所有不命中的查找次数
+    };
+
     // 构造函数：初始化哈希表
     // 确保表的大小是素数，通常能提供更好的哈希分布
-    explicit HashTable(int initialSize = 101) : currentElementCount(0) {
-        // nextPrime(initialSize) 确保 initialSize 即使不是素数也能得到一个合适的素数大小
-        theBuckets.resize(nextPrime(initialSize));
+    explicit HashTable(int initialSize = 101, RehashMode mode = RehashMode::ALL_AT_ONCE)
+        : currentElementCount(0), rehashMode(mode), migratePos(0) {
+        // nextPrime(initialSize) 确保 initialSize 即使不是素数也能得到一个合适的素数大小（由 SizePolicy 决定）
+        theBuckets.resize(SizePolicy::nextSize(initialSize));
+    }
+
+    // 拷贝构造函数
+    // 溢出结点属于各自的结点池，不能直接拷贝指针，所以逐个元素插入到新表中
+    HashTable(const HashTable &rhs) : HashTable(static_cast<int>(rhs.theBuckets.size()), rhs.rehashMode) {
+        if (rhs.bloomBitsPerElement > 0) {
+            enableBloomFilter(rhs.bloomBitsPerElement);
+        }
+        rhs.forEachElement([this](const HashedObj &item) {
+            insert(item);
+        });
+    }
+
+    HashTable(HashTable &&rhs) = default;
+
+    // 拷贝赋值运算符：copy-and-swap
+    HashTable &operator=(HashTable rhs) {
+        std::swap(theBuckets, rhs.theBuckets);
+        std::swap(oldBuckets, rhs.oldBuckets);
+        std::swap(pool, rhs.pool);
+        std::swap(currentElementCount, rhs.currentElementCount);
+        std::swap(rehashMode, rhs.rehashMode);
+        std::swap(migratePos, rhs.migratePos);
+        std::swap(bloom, rhs.bloom);
+        std::swap(oldBloom, rhs.oldBloom);
+        std::swap(bloomBitsPerElement, rhs.bloomBitsPerElement);
+        std::swap(removedSinceBloomBuild, rhs.removedSinceBloomBuild);
+        std::swap(bloomNegatives, rhs.bloomNegatives);
+        std::swap(bloomFalsePositives, rhs.bloomFalsePositives);
+        return *this;
     }
 
     // 检查元素是否存在
     bool contains(const HashedObj &x) const {
-        // const list<HashedObj>& targetList = theBuckets[myHash(x)];
-        // return std::find(targetList.begin(), targetList.end(), x) != targetList.end();
+        return findKey(x) != nullptr;
+    }
 
-        // 改进：直接使用链表的迭代器进行查找，避免创建不必要的引用
-        // 如果 find 返回 end()，则表示没找到
-        return std::find(theBuckets[myHash(x)].begin(), theBuckets[myHash(x)].end(), x) != theBuckets[myHash(x)].end();
+    // 异构查找：哈希函数是透明的时候（例如 HashedObj 为 std::string），可以直接用 string_view、const char * 查找，
+    // 不需要构造临时的 HashedObj，也就没有内存分配。Key 必须能和 HashedObj 用 == 比较
+    template<class Key, class H = Hash, class = typename H::is_transparent>
+    bool contains(const Key &key) const {
+        return findKey(key) != nullptr;
+    }
+
+    // 查找元素，返回它在表中的地址，不存在时返回 nullptr
+    // 一次查找既能判断是否存在，又能拿到元素本身（例如 SepChainingMap.cpp 中用它取出 value）
+    // 返回的指针只在下一次操作之前有效：插入可能触发 rehash，渐进式模式下连 contains 也会搬动元素
+    const HashedObj *find(const HashedObj &x) const {
+        return findKey(x);
+    }
+
+    // 异构查找版本的 find，要求同 contains
+    template<class Key, class H = Hash, class = typename H::is_transparent>
+    const HashedObj *find(const Key &key) const {
+        return findKey(key);
     }
 
     // 清空哈希表
+    // 溢出结点都在结点池里，直接整体释放即可，不需要逐个链表地清理
     void makeEmpty() {
         for (auto &bucket : theBuckets) {
-            bucket.clear();
+            resetBucket(bucket);
         }
-        currentElementCount = 0;    // 重置元素计数
+        std::vector<Bucket>().swap(oldBuckets);    // 正在进行的迁移也一并放弃
+        pool.clear();
+        migratePos = 0;
+        currentElementCount = 0;                   // 重置元素计数
+        bloom.clear();
+        oldBloom.release();
+        removedSinceBloomBuild = 0;
     }
 
-    // 插入元素
-    bool insert(const HashedObj &x) {
-        // 获取对应哈希值的链表引用
-        std::list<HashedObj> &targetList = theBuckets[myHash(x)];
+    // 打开布隆过滤器：按当前桶数（负载因子不超过 1，元素个数不会超过桶数）建立过滤器，并加入已有的所有元素
+    // bitsPerElement 越大假阳性率越低：10 bit 约 1%，16 bit 约 0.1% 左右（分块过滤器比理论值略高一点）
+    void enableBloomFilter(int bitsPerElement = 10) {
+        bloomBitsPerElement = bitsPerElement;
+        rebuildBloomFilter();
+        bloomNegatives = 0;
+        bloomFalsePositives = 0;
+    }
 
-        // 检查元素是否已存在，如果存在则不插入
-        if (std::find(targetList.begin(), targetList.end(), x) != targetList.end()) {
-            return false;    // 元素已存在
-        }
+    // 关闭布隆过滤器，释放内存
+    void disableBloomFilter() {
+        bloomBitsPerElement = 0;
+        bloom.release();
+        oldBloom.release();
+    }
 
-        // 将元素添加到链表末尾
-        targetList.push_back(x);
+    // 布隆过滤器是否打开
+    bool hasBloomFilter() const {
+        return bloomBitsPerElement > 0;
+    }
 
-        // 增加当前元素数量
-        currentElementCount++;
+    // 布隆过滤器的内存占用和实测假阳性率
+    BloomFilterStats bloomFilterStats() const {
+        BloomFilterStats stats;
+        stats.memoryBytes = bloom.memoryUsage() + oldBloom.memoryUsage();
+        stats.bitsPerElement = currentElementCount == 0 ? 0.0 : 8.0 * stats.memoryBytes / currentElementCount;
+        stats.negatives = bloomNegatives;
+        stats.falsePositives = bloomFalsePositives;
+        long long misses = bloomNegatives + bloomFalsePositives;
+        stats.falsePositiveRate = misses == 0 ? 0.0 : static_cast<double>(bloomFalsePositives) / misses;
+        return stats;
+    }
 
-        // 检查负载因子，如果超过阈值，则触发再散列
-        // 对于分离链接法，负载因子通常可以设定得比1大，比如1.5或2.0，具体取决于链表操作的性能
-        // 这里的阈值设置为当元素数量等于桶的数量时触发，即负载因子约为 1.0
-        if (currentElementCount > theBuckets.size()) {
-            rehash();
+    // 批量查找：keys 中共 count 个元素，results 非空时把每个元素是否存在写到 results[i]，返回存在的个数
+    // 逐个 contains 时，每次找桶都要等一次 cache miss，CPU 大部分时间在空等内存
+    // 批量查找分两遍：先算出一批 key 的桶下标并预取（prefetch）这些桶，再逐个在桶里查找
+    // 多个 cache miss 的等待时间重叠在一起。桶里有内联数组，预取一次桶就覆盖了绝大多数查找要访问的内存
+    // 每次只预取 BATCH_SIZE 个，太多的话先取进来的会在用到之前被挤出 cache
+    // 渐进式迁移在每一批开始前统一推进，一批之内桶数组不会变化，预取的位置始终有效
+    int containsBatch(const HashedObj *keys, size_t count, bool *results = nullptr) const {
+        int found = 0;
+        int indices[BATCH_SIZE];
+        for (size_t base = 0; base < count; base += BATCH_SIZE) {
+            int n = static_cast<int>(std::min<size_t>(BATCH_SIZE, count - base));
+            migrateBuckets(MIGRATE_BUCKETS_PER_OP * n);
+            for (int i = 0; i < n; ++i) {
+                // 布隆过滤器判定一定不在的，不用预取也不用查桶，下标记为 -1
+                if (!mayContain(keys[base + i])) {
+                    indices[i] = -1;
+                    continue;
+                }
+                indices[i] = myHash(keys[base + i], theBuckets.size());
+                prefetch(&theBuckets[indices[i]]);
+            }
+            for (int i = 0; i < n; ++i) {
+                const HashedObj &x = keys[base + i];
+                bool hit = false;
+                if (indices[i] != -1) {
+                    hit = findInBucket(theBuckets[indices[i]], x) != nullptr;
+                    if (!hit) {
+                        const Bucket *oldBucket = findOldBucket(x);
+                        hit = oldBucket != nullptr && findInBucket(*oldBucket, x) != nullptr;
+                    }
+                    countFalsePositive(hit);
+                }
+                found += hit;
+                if (results != nullptr) {
+                    results[base + i] = hit;
+                }
+            }
         }
+        return found;
+    }
 
-        return true;    // 插入成功
+    // 批量插入，返回实际插入（之前不存在）的元素个数
+    // 和 containsBatch 一样先算桶下标、预取，再逐个插入
+    // 插入过程中可能触发 rehash，桶数变了之前算好的下标就失效了，这一批剩下的元素重新计算下标
+    int insertBatch(const HashedObj *keys, size_t count) {
+        int inserted = 0;
+        int indices[BATCH_SIZE];
+        for (size_t base = 0; base < count; base += BATCH_SIZE) {
+            int n = static_cast<int>(std::min<size_t>(BATCH_SIZE, count - base));
+            migrateBuckets(MIGRATE_BUCKETS_PER_OP * n);
+            size_t prefetchedCount = theBuckets.size();
+            for (int i = 0; i < n; ++i) {
+                indices[i] = myHash(keys[base + i], theBuckets.size());
+                prefetch(&theBuckets[indices[i]]);
+            }
+            for (int i = 0; i < n; ++i) {
+                const HashedObj &x = keys[base + i];
+                int index = theBuckets.size() == prefetchedCount ? indices[i] : myHash(x, theBuckets.size());
+                inserted += insertInto(x, index);
+            }
+        }
+        return inserted;
+    }
+
+    // 插入元素
+    bool insert(const HashedObj &x) {
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+        return insertInto(x, myHash(x, theBuckets.size()));
+    }
+
+    // 插入元素（移动版本）：x 直接移动进桶里，不拷贝
+    bool insert(HashedObj &&x) {
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+        int index = myHash(x, theBuckets.size());
+        return insertInto(std::move(x), index);
+    }
+
+    // 用 args 原地构造一个元素并插入
+    // 元素要先构造出来才能计算哈希值、判断是否重复，所以构造之后按移动版本插入，全程没有拷贝
+    template<class... Args>
+    bool emplace(Args &&...args) {
+        return insert(HashedObj(std::forward<Args>(args)...));
     }
 
     // 删除元素
     bool remove(const HashedObj &x) {
-        std::list<HashedObj> &targetList = theBuckets[myHash(x)];
-        // typename关键字 明确告诉编译器 std::list<HashedObj>::iterator 是一个类型名
-        typename std::list<HashedObj>::iterator itr = std::find(targetList.begin(), targetList.end(), x);
-
-        // 如果未找到元素，则返回 false
-        if (itr == targetList.end()) {
-            return false;
-        }
+        return removeKey(x);
+    }
 
-        // 从链表中移除元素
-        targetList.erase(itr);
-        currentElementCount--;    // 减少当前元素数量
-        return true;              // 删除成功
+    // 异构删除，要求同 contains
+    template<class Key, class H = Hash, class = typename H::is_transparent>
+    bool remove(const Key &key) {
+        return removeKey(key);
     }
 
     // 获取当前哈希表中元素的数量
@@ -124,27 +524,390 @@ public:
         return theBuckets.size();
     }
 
+    // 是否正处于渐进式 rehash 的迁移过程中
+    bool isRehashing() const {
+        return !oldBuckets.empty();
+    }
+
+    // 桶长度的直方图：返回值的第 i 项是恰好有 i 个元素的桶的个数
+    // 哈希函数越均匀，直方图越接近泊松分布（装填因子为 1 时约 37% 的桶为空、37% 有 1 个元素）
+    // 会先把正在进行的迁移做完，是 O(桶数) 的操作，只用于观察，不要放在热路径上
+    std::vector<int> bucketLengthHistogram() const {
+        migrateBuckets(oldBuckets.size());
+        std::vector<int> histogram;
+        for (const Bucket &bucket : theBuckets) {
+            size_t length = bucket.inlineCount;
+            for (const Node *node = bucket.overflow; node != nullptr; node = node->next) {
+                length++;
+            }
+            if (length >= histogram.size()) {
+                histogram.resize(length + 1, 0);
+            }
+            histogram[length]++;
+        }
+        return histogram;
+    }
+
+    // 估算哈希表占用的内存（字节）：桶数组 + 结点池
+    // 不包含元素自己在堆上持有的内存（例如 string 的字符缓冲区）
+    size_t memoryUsage() const {
+        return (theBuckets.capacity() + oldBuckets.capacity()) * sizeof(Bucket) + pool.capacity() * sizeof(Node);
+    }
+
     // 打印哈希表内容（用于调试）
     void printHashTable() const {
         std::cout << "--- Hash Table Contents (Size: " << currentElementCount << ", Buckets: " << theBuckets.size() << ") ---" << std::endl;
         for (int i = 0; i < theBuckets.size(); ++i) {
             std::cout << "Bucket " << i << ": ";
-            if (theBuckets[i].empty()) {
+            if (theBuckets[i].inlineCount == 0) {
                 std::cout << "(empty)";
             } else {
-                for (const auto &item : theBuckets[i]) {
-                    std::cout << item << " -> ";
-                }
+                printBucket(theBuckets[i]);
                 std::cout << "NULL";    // 链表末尾
             }
             std::cout << std::endl;
         }
+        // 迁移期间，把旧表中还没搬走的桶也打印出来
+        for (size_t i = migratePos; i < oldBuckets.size(); ++i) {
+            if (oldBuckets[i].inlineCount != 0) {
+                std::cout << "Old bucket " << i << ": ";
+                printBucket(oldBuckets[i]);
+                std::cout << "NULL" << std::endl;
+            }
+        }
         std::cout << "---------------------------------------------------" << std::endl;
     }
 
 private:
-    std::vector<std::list<HashedObj>> theBuckets;    // 哈希桶，重命名为theBuckets更清晰
-    int currentElementCount;                         // 当前元素数量，重命名为currentElementCount更清晰
+    // 每次操作最多搬运的旧桶数量
+    // 新表是旧表的两倍，下一次 rehash 至少要再插入 旧桶数 个元素才会触发，每次搬 1 个就足够在那之前搬完
+    // 取 2 留一些余量，同时单次操作的额外开销仍是常数
+    static constexpr int MIGRATE_BUCKETS_PER_OP = 2;
+
+    // 每个桶内联存放的元素个数：小元素（int 等）放 3 个，大元素少放几个，避免空桶浪费太多空间
+    static constexpr int INLINE_CAPACITY = sizeof(HashedObj) >= 32 ? 1 : (sizeof(HashedObj) >= 16 ? 2 : 3);
+
+    // 批量操作每次预取的元素个数
+    static constexpr int BATCH_SIZE = 16;
+
+    using Node = ChainNode<HashedObj>;
+
+    // 桶：内联数组 + 溢出链表
+    // 约定：只有内联数组放满时，overflow 才可能非空。这样查找时先扫内联数组，绝大多数情况下根本不用碰链表
+    struct Bucket {
+        HashedObj items[INLINE_CAPACITY];    // 内联存放的元素
+        int inlineCount = 0;                 // 内联数组中的元素个数
+        Node *overflow = nullptr;            // 溢出链表头
+    };
+
+    // 迁移是对调用者不可见的内部状态，元素集合不会因此改变，所以 contains 这样的 const 操作也可以顺手推进迁移
+    // 这就是 mutable 的典型用途
+    mutable std::vector<Bucket> theBuckets;    // 哈希桶，重命名为theBuckets更清晰
+    mutable std::vector<Bucket> oldBuckets;    // 渐进式 rehash 期间的旧桶，迁移完成后为空
+    mutable NodePool<HashedObj> pool;          // 溢出结点池，新旧两个桶数组共用
+    int currentElementCount;                   // 当前元素数量，重命名为currentElementCount更清晰
+    RehashMode rehashMode;                     // rehash 方式
+    mutable size_t migratePos;                 // 旧桶中下一个待迁移的下标
+
+    // 布隆过滤器，bloomBitsPerElement 为 0 表示没有打开
+    // 迁移期间，还没搬走的旧桶里的元素在 oldBloom 中，搬走的和新插入的在 bloom 中
+    mutable BlockedBloomFilter bloom;
+    mutable BlockedBloomFilter oldBloom;
+    int bloomBitsPerElement = 0;
+    int removedSinceBloomBuild = 0;            // 上次重建以来删除的元素个数
+    mutable long long bloomNegatives = 0;      // 统计用，见 BloomFilterStats
+    mutable long long bloomFalsePositives = 0;
+
+    // --- 桶操作 ---
+
+    // 在桶中查找 x，返回元素地址，找不到返回 nullptr
+    template<class Key>
+    const HashedObj *findInBucket(const Bucket &bucket, const Key &x) const {
+        for (int i = 0; i < bucket.inlineCount; ++i) {
+            if (bucket.items[i] == x) {
+                return &bucket.items[i];
+            }
+        }
+        for (const Node *node = bucket.overflow; node != nullptr; node = node->next) {
+            if (node->element == x) {
+                return &node->element;
+            }
+        }
+        return nullptr;
+    }
+
+    // 把 x 放入桶中：内联数组有空位就放内联数组，否则从结点池取一个结点头插到溢出链表
+    // x 是右值时移动进去，否则拷贝
+    template<class T>
+    void pushToBucket(Bucket &bucket, T &&x) const {
+        if (bucket.inlineCount < INLINE_CAPACITY) {
+            bucket.items[bucket.inlineCount++] = std::forward<T>(x);
+            return;
+        }
+        Node *node = pool.allocate();
+        node->element = std::forward<T>(x);
+        node->next = bucket.overflow;
+        bucket.overflow = node;
+    }
+
+    // 把一个已有的溢出结点挂到桶上（rehash 用）
+    // 内联数组有空位时，元素搬进内联数组，结点还给池子；否则直接把结点链进溢出链表，元素不动
+    void relinkToBucket(Bucket &bucket, Node *node) const {
+        if (bucket.inlineCount < INLINE_CAPACITY) {
+            bucket.items[bucket.inlineCount++] = std::move(node->element);
+            pool.deallocate(node);
+            return;
+        }
+        node->next = bucket.overflow;
+        bucket.overflow = node;
+    }
+
+    // 从桶中删除 x，返回是否找到
+    template<class Key>
+    bool eraseFromBucket(Bucket &bucket, const Key &x) const {
+        for (int i = 0; i < bucket.inlineCount; ++i) {
+            if (bucket.items[i] == x) {
+                // 用内联数组的最后一个元素填补空位
+                int last = bucket.inlineCount - 1;
+                bucket.items[i] = std::move(bucket.items[last]);
+                if (bucket.overflow != nullptr) {
+                    // 溢出链表非空，说明内联数组是满的：把链表头的元素补进内联数组，维持约定
+                    Node *head = bucket.overflow;
+                    bucket.items[last] = std::move(head->element);
+                    bucket.overflow = head->next;
+                    pool.deallocate(head);
+                } else {
+                    bucket.items[last] = HashedObj();
+                    bucket.inlineCount--;
+                }
+                return true;
+            }
+        }
+        // 在溢出链表中查找，用指向指针的指针统一处理头结点和中间结点
+        for (Node **link = &bucket.overflow; *link != nullptr; link = &(*link)->next) {
+            if ((*link)->element == x) {
+                Node *target = *link;
+                *link = target->next;
+                pool.deallocate(target);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 清空一个桶，溢出结点还给池子
+    void resetBucket(Bucket &bucket) const {
+        for (int i = 0; i < bucket.inlineCount; ++i) {
+            bucket.items[i] = HashedObj();
+        }
+        bucket.inlineCount = 0;
+        bucket.overflow = nullptr;
+    }
+
+    // 打印一个桶中的所有元素
+    void printBucket(const Bucket &bucket) const {
+        for (int i = 0; i < bucket.inlineCount; ++i) {
+            std::cout << bucket.items[i] << " -> ";
+        }
+        for (const Node *node = bucket.overflow; node != nullptr; node = node->next) {
+            std::cout << node->element << " -> ";
+        }
+    }
+
+    // 遍历表中（包括尚未迁移的旧桶中）的每一个元素
+    template<class Func>
+    void forEachElement(Func func) const {
+        auto visit = [&func](const Bucket &bucket) {
+            for (int i = 0; i < bucket.inlineCount; ++i) {
+                func(bucket.items[i]);
+            }
+            for (const Node *node = bucket.overflow; node != nullptr; node = node->next) {
+                func(node->element);
+            }
+        };
+        for (const auto &bucket : theBuckets) {
+            visit(bucket);
+        }
+        for (size_t i = migratePos; i < oldBuckets.size(); ++i) {
+            visit(oldBuckets[i]);
+        }
+    }
+
+    // 查找和删除的实现，Key 为 HashedObj 或者透明哈希允许的其他类型
+    template<class Key>
+    const HashedObj *findKey(const Key &x) const {
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+
+        // 布隆过滤器判定一定不在，直接返回，不碰桶
+        if (!mayContain(x)) {
+            return nullptr;
+        }
+        const HashedObj *found = findInBucket(theBuckets[myHash(x, theBuckets.size())], x);
+        if (found == nullptr) {
+            // 迁移期间，元素可能还留在旧表中
+            const Bucket *oldBucket = findOldBucket(x);
+            found = oldBucket != nullptr ? findInBucket(*oldBucket, x) : nullptr;
+        }
+        countFalsePositive(found != nullptr);
+        return found;
+    }
+
+    template<class Key>
+    bool removeKey(const Key &x) {
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+
+        // 先在新表中删除，没找到再去还没搬完的旧表中找
+        if (!eraseFromBucket(theBuckets[myHash(x, theBuckets.size())], x)) {
+            Bucket *oldBucket = const_cast<Bucket *>(findOldBucket(x));
+            // 如果未找到元素，则返回 false
+            if (oldBucket == nullptr || !eraseFromBucket(*oldBucket, x)) {
+                return false;
+            }
+        }
+
+        currentElementCount--;    // 减少当前元素数量
+
+        // 被删元素的 bit 还留在布隆过滤器里，删得多了就按现有元素重建，把假阳性率降回来
+        if (bloomBitsPerElement > 0 && ++removedSinceBloomBuild > currentElementCount) {
+            rebuildBloomFilter();
+        }
+        return true;              // 删除成功
+    }
+
+    // --- 布隆过滤器 ---
+
+    // 布隆过滤器用的 64 位哈希值，先经过 mixHash，和桶下标（SizePolicy::index）互不相关
+    template<class Key>
+    static uint64_t bloomHash(const Key &x) {
+        return mixHash(static_cast<uint64_t>(Hash{}(x)));
+    }
+
+    // 没有打开过滤器时总是返回 true
+    template<class Key>
+    bool mayContain(const Key &x) const {
+        if (bloomBitsPerElement == 0) {
+            return true;
+        }
+        uint64_t h = bloomHash(x);
+        if (bloom.mayContain(h) || (!oldBloom.empty() && oldBloom.mayContain(h))) {
+            return true;
+        }
+        bloomNegatives++;
+        return false;
+    }
+
+    // 过滤器回答“可能在”之后，根据查桶的结果统计假阳性
+    void countFalsePositive(bool found) const {
+        if (bloomBitsPerElement > 0 && !found) {
+            bloomFalsePositives++;
+        }
+    }
+
+    // 把一个元素加入过滤器
+    template<class Key>
+    void bloomAdd(const Key &x) const {
+        if (bloomBitsPerElement > 0) {
+            bloom.add(bloomHash(x));
+        }
+    }
+
+    // 按当前桶数新建过滤器，加入所有元素（包括还没迁移的旧桶中的元素），旧过滤器不再需要
+    void rebuildBloomFilter() {
+        bloom = BlockedBloomFilter(theBuckets.size(), bloomBitsPerElement);
+        oldBloom.release();
+        forEachElement([this](const HashedObj &item) {
+            bloom.add(bloomHash(item));
+        });
+        removedSinceBloomBuild = 0;
+    }
+
+    // 预取 p 所在的 cache line，只是提示，不会改变程序语义，不支持的编译器上什么都不做
+    static void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p, 0, 1);
+#else
+        (void)p;
+#endif
+    }
+
+    // 把元素插入新表中下标为 index 的桶，index 已经由调用者算好
+    // x 是右值时移动进桶里，否则拷贝
+    template<class T>
+    bool insertInto(T &&x, int index) {
+        // 获取对应哈希值的桶
+        Bucket &targetBucket = theBuckets[index];
+
+        // 检查元素是否已存在，如果存在则不插入
+        if (findInBucket(targetBucket, x) != nullptr) {
+            return false;    // 元素已存在
+        }
+        const Bucket *oldBucket = findOldBucket(x);
+        if (oldBucket != nullptr && findInBucket(*oldBucket, x) != nullptr) {
+            return false;    // 元素在还没搬完的旧表中
+        }
+
+        // 将元素放入桶中（x 可能被移走，所以先加入布隆过滤器）
+        bloomAdd(x);
+        pushToBucket(targetBucket, std::forward<T>(x));
+
+        // 增加当前元素数量
+        currentElementCount++;
+
+        // 检查负载因子，如果超过阈值，则触发再散列
+        // 对于分离链接法，负载因子通常可以设定得比1大，比如1.5或2.0，具体取决于链表操作的性能
+        // 这里的阈值设置为当元素数量等于桶的数量时触发，即负载因子约为 1.0
+        if (currentElementCount > theBuckets.size()) {
+            rehash();
+        }
+
+        return true;    // 插入成功
+    }
+
+    // 如果 x 在旧表中对应的桶还没有被迁移，返回这个桶；否则返回 nullptr
+    template<class Key>
+    const Bucket *findOldBucket(const Key &x) const {
+        if (oldBuckets.empty()) {
+            return nullptr;
+        }
+        size_t oldIndex = myHash(x, oldBuckets.size());
+        return oldIndex >= migratePos ? &oldBuckets[oldIndex] : nullptr;
+    }
+
+    // 从 migratePos 开始，最多把 count 个旧桶搬到新表
+    // 溢出结点直接从旧桶摘下、重新挂到新桶上，不会重新分配；内联元素用移动赋值搬过去
+    void migrateBuckets(size_t count) const {
+        if (oldBuckets.empty()) {
+            return;
+        }
+        for (size_t end = std::min(oldBuckets.size(), migratePos + count); migratePos < end; ++migratePos) {
+            Bucket &oldBucket = oldBuckets[migratePos];
+            // 先搬溢出结点：它们还给池子的结点，正好可以给后面放不进内联数组的元素用
+            Node *node = oldBucket.overflow;
+            while (node != nullptr) {
+                Node *next = node->next;
+                bloomAdd(node->element);
+                relinkToBucket(theBuckets[myHash(node->element, theBuckets.size())], node);
+                node = next;
+            }
+            oldBucket.overflow = nullptr;
+            for (int i = 0; i < oldBucket.inlineCount; ++i) {
+                bloomAdd(oldBucket.items[i]);
+                Bucket &newBucket = theBuckets[myHash(oldBucket.items[i], theBuckets.size())];
+                if (newBucket.inlineCount < INLINE_CAPACITY) {
+                    newBucket.items[newBucket.inlineCount++] = std::move(oldBucket.items[i]);
+                } else {
+                    pushToBucket(newBucket, std::move(oldBucket.items[i]));
+                }
+            }
+            oldBucket.inlineCount = 0;
+        }
+        // 全部搬完，释放旧桶数组（旧元素都已经加进新的布隆过滤器，旧过滤器也可以释放了）
+        if (migratePos == oldBuckets.size()) {
+            std::vector<Bucket>().swap(oldBuckets);
+            oldBloom.release();
+            migratePos = 0;
+        }
+    }
 
     // 再散列函数
     // 增加哈希表的大小，并重新分布所有元素
@@ -164,43 +927,185 @@ private:
         // 1. move把theBuckets从左值转换为右值引用
         // 2. 右值引用绑定到对象oldBuckets，触发了移动构造，oldBuckets现在拥有theBuckets的资源，且theBuckets自身变为空
         // 3. 后面扩容后，直到函数结束，oldBuckets临时变量会被销毁，释放原有的资源
-        std::vector<std::list<HashedObj>> oldBuckets = std::move(theBuckets);    // 使用 std::move 避免拷贝，提高效率
 
-        // 调整新哈希表的大小为当前大小的两倍的下一个素数
-        theBuckets.resize(nextPrime(2 * oldBuckets.size()));
+        // 上一次渐进式迁移还没完成（只有在大量 remove 之后又快速 insert 时才可能发生），先把它做完
+        migrateBuckets(oldBuckets.size());
 
-        currentElementCount = 0;    // 重置计数，因为后续 insert 会重新计数
+        oldBuckets = std::move(theBuckets);    // 使用 std::move 避免拷贝，提高效率
 
-        // 遍历旧的哈希表中的所有元素，并重新插入到新的哈希表中
-        for (auto &oldBucket : oldBuckets) {        // 使用范围for循环遍历旧桶
-            for (const auto &item : oldBucket) {    // 遍历旧桶中的每个链表元素
-                insert(item);                       // 重新插入，这会再次调用 myHash 和 insert 逻辑
-            }
+        // 调整新哈希表的大小为当前大小的两倍的下一个素数（由 SizePolicy 决定）
+        theBuckets.resize(SizePolicy::nextSize(2 * oldBuckets.size()));
+        migratePos = 0;
+
+        // 布隆过滤器按新的桶数重建：新插入的和迁移过来的元素进新过滤器，旧过滤器留到迁移结束
+        if (bloomBitsPerElement > 0) {
+            oldBloom = std::move(bloom);
+            bloom = BlockedBloomFilter(theBuckets.size(), bloomBitsPerElement);
+        }
+
+        // 遍历旧的哈希表中的所有元素，并搬到新的哈希表中
+        // 元素数量不变，所以 currentElementCount 不需要调整
+        // 一次性模式下立即全部搬完；渐进式模式下留给之后的操作，每次搬几个桶
+        if (rehashMode == RehashMode::ALL_AT_ONCE) {
+            migrateBuckets(oldBuckets.size());
         }
-        // 注意：rehash 过程中每次 insert 都会增加 currentElementCount，但不会再次触发 rehash
-        // 因为 rehash 的目的是一次性完成扩容，而不是在扩容过程中再次扩容
-        // 最终的 currentElementCount 应该与原始的元素数量一致
     }
 
     // 核心哈希映射函数
-    // 负责将 HashedObj 映射到 `theBuckets` 数组的有效索引
-    int myHash(const HashedObj &x) const {
-        // 使用std::hash模板，它为基本类型和 std::string 等提供了默认实现
+    // 负责将 HashedObj 映射到桶数组的有效索引
+    // Key 是 HashedObj 以外的类型时（异构查找），透明的 Hash 保证它和对应的 HashedObj 算出相同的哈希值
+    template<class Key>
+    int myHash(const Key &x, size_t bucketCount) const {
+        // 默认的 DefaultHash 内部使用std::hash模板，它为基本类型和 std::string 等提供了默认实现
         // 如果HashedObj是自定义类型，需要为HashedObj特化std::hash，或提供一个友元函数
         // std::hash 的 operator() 返回一个 size_t 类型的值
         // 这里使用花括号是在创建匿名对象，用圆括号也行
         // 不过花括号统一表示“初始化”操作，更符合编程规范。其他初始化操作大多也是用花括号完成的
-        size_t hashVal = std::hash<HashedObj>{}(x);    // 使用 std::hash 对象
-        // std::hash<HashedObj>{}：创建了一个 std::hash<HashedObj> 类型的匿名临时对象，并调用了其默认构造函数。
+        size_t hashVal = Hash{}(x);    // 使用 Hash 对象（默认是 DefaultHash，一般类型就是 std::hash）
+        // Hash{}：创建了一个 Hash 类型的匿名临时对象，并调用了其默认构造函数。
         // 紧接着的 (x)：调用了这个临时对象的 operator() 成员函数，并将 x 作为参数传递，从而计算出 x 的哈希值。
 
-        // 对哈希值取模，确保它落在 [0, theBuckets.size() - 1] 范围内
-        hashVal %= theBuckets.size();
+        // 由 SizePolicy 把哈希值映射到 [0, bucketCount - 1] 范围内（默认就是取模）
+        // 渐进式 rehash 期间新旧两张表的桶数不同，所以桶数由调用者传入
+        hashVal = SizePolicy::index(hashVal, bucketCount);
 
         return static_cast<int>(hashVal);    // 转换为 int 类型返回
     }
 };
 
+// 其他文件（例如 ConcurrentHash.cpp）会直接 #include 本文件来复用 HashTable
+// 它们在 #include 之前定义 SEP_CHAINING_NO_MAIN，跳过下面的测试代码和 main
+#ifndef SEP_CHAINING_NO_MAIN
+
+// --- 容量策略的性能对比 ---
+
+// 用同一组 key 测试一种容量策略：先插入，再做同样数量的命中查找和不命中查找
+// key 的最低位都是 0，key | 1 一定不在表中
+template<class Policy>
+void benchmarkSizePolicy(const char *name, const std::vector<int> &keys) {
+    HashTable<int, Policy> table;
+    auto start = std::chrono::steady_clock::now();
+    for (int k : keys) {
+        table.insert(k);
+    }
+    auto inserted = std::chrono::steady_clock::now();
+    int found = 0;
+    for (int k : keys) {
+        found += table.contains(k);
+        found += table.contains(k | 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double insertMs = std::chrono::duration<double, std::milli>(inserted - start).count();
+    double lookupMs = std::chrono::duration<double, std::milli>(end - inserted).count();
+    std::cout << "  " << name << ": insert " << insertMs << " ms, lookup " << lookupMs << " ms, buckets " << table.bucketCount()
+              << ", found " << found << std::endl;
+}
+
+// --- 批量操作（预取）的性能对比 ---
+
+// 同一组 key，分别用逐个 insert/contains 和每 batch 个一组的 insertBatch/containsBatch 处理，比较耗时
+// 查询一半命中、一半不命中，顺序随机。表要明显大于 cache，预取才有意义
+template<class Table>
+void benchmarkBatch(const std::vector<int> &keys, const std::vector<int> &queries, size_t batch) {
+    Table single, batched;
+    auto start = std::chrono::steady_clock::now();
+    for (int k : keys) {
+        single.insert(k);
+    }
+    auto singleInserted = std::chrono::steady_clock::now();
+    for (size_t base = 0; base < keys.size(); base += batch) {
+        batched.insertBatch(&keys[base], std::min(batch, keys.size() - base));
+    }
+    auto batchInserted = std::chrono::steady_clock::now();
+
+    int singleFound = 0;
+    for (int q : queries) {
+        singleFound += single.contains(q);
+    }
+    auto singleLooked = std::chrono::steady_clock::now();
+    int batchFound = 0;
+    for (size_t base = 0; base < queries.size(); base += batch) {
+        batchFound += batched.containsBatch(&queries[base], std::min(batch, queries.size() - base));
+    }
+    auto batchLooked = std::chrono::steady_clock::now();
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "  insert:   one by one " << ms(start, singleInserted) << " ms, batch " << ms(singleInserted, batchInserted)
+              << " ms (size " << single.size() << " / " << batched.size() << ")" << std::endl;
+    std::cout << "  contains: one by one " << ms(batchInserted, singleLooked) << " ms, batch " << ms(singleLooked, batchLooked)
+              << " ms (found " << singleFound << " / " << batchFound << ")" << std::endl;
+}
+
+// --- 异构查找的性能对比 ---
+
+// 手里只有 string_view 时查找 std::string 表：先构造临时 std::string 再查 vs 直接用 string_view 查
+// key 的长度超过了短字符串优化（SSO）的上限，构造临时 std::string 一定会分配内存
+template<class Table>
+void benchmarkHeterogeneousLookup(int n, int rounds) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < n; ++i) {
+        keys.push_back("user:session:id:" + std::to_string(i * 7919));
+    }
+    Table table;
+    for (const auto &k : keys) {
+        table.insert(k);
+    }
+    std::vector<std::string_view> views(keys.begin(), keys.end());
+
+    auto start = std::chrono::steady_clock::now();
+    int tempFound = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (std::string_view v : views) {
+            tempFound += table.contains(std::string(v));
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    int viewFound = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (std::string_view v : views) {
+            viewFound += table.contains(v);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "  temporary std::string: " << std::chrono::duration<double, std::milli>(middle - start).count() << " ms"
+              << ", string_view: " << std::chrono::duration<double, std::milli>(end - middle).count() << " ms"
+              << " (found " << tempFound << " / " << viewFound << ")" << std::endl;
+}
+
+// 不命中为主的查找：不加过滤器 vs 布隆过滤器（bitsPerElement 取几个不同的值）
+// keys 全部插入，queries 中命中的比例由调用者决定
+void benchmarkBloomFilter(const std::vector<int> &keys, const std::vector<int> &queries) {
+    for (int bits : {0, 8, 10, 16}) {
+        HashTable<int> table;
+        for (int k : keys) {
+            table.insert(k);
+        }
+        if (bits > 0) {
+            table.enableBloomFilter(bits);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        int found = 0;
+        for (int q : queries) {
+            found += table.contains(q);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::string label = bits == 0 ? "no filter     " : "bloom, " + std::string(bits < 10 ? " " : "") + std::to_string(bits) + " bits";
+        std::cout << "  " << label << ": " << std::chrono::duration<double, std::milli>(end - start).count() << " ms (found " << found << ")";
+        if (bits > 0) {
+            auto stats = table.bloomFilterStats();
+            std::cout << ", FP rate " << stats.falsePositiveRate * 100 << "%, filter " << stats.memoryBytes / 1024 << " KB ("
+                      << stats.bitsPerElement << " bits/element)";
+        }
+        std::cout << ", table " << table.memoryUsage() / 1024 << " KB" << std::endl;
+    }
+}
+
 // --- 主函数测试 ---
 
 int main() {
@@ -260,5 +1165,108 @@ int main() {
     stringHashTable.makeEmpty();
     stringHashTable.printHashTable();
 
+    // 3. 渐进式 rehash
+    std::cout << "\n--- Testing incremental rehash ---" << std::endl;
+    HashTable<int> incTable(7, RehashMode::INCREMENTAL);
+    for (int i = 0; i < 9; ++i) {
+        incTable.insert(i * 10);
+    }
+    std::cout << "Rehashing in progress: " << (incTable.isRehashing() ? "Yes" : "No") << std::endl;
+    incTable.printHashTable();    // 部分元素还在旧桶中
+    std::cout << "Contains 80: " << (incTable.contains(80) ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 0: " << (incTable.remove(0) ? "OK" : "Not found") << std::endl;
+    for (int i = 0; i < 10; ++i) {
+        incTable.contains(i);    // 查询也会推进迁移
+    }
+    std::cout << "Rehashing in progress: " << (incTable.isRehashing() ? "Yes" : "No") << std::endl;
+    incTable.printHashTable();
+
+    // 4. 单次 insert 的延迟：一次性 rehash vs 渐进式 rehash
+    // 一次性 rehash 的最大延迟随表的大小线性增长，渐进式 rehash 则基本保持平稳
+    // 注意渐进式的 max 里仍然包含“分配并初始化新桶数组”这一步，它同样是 O(桶数) 的，只是比搬运元素便宜得多
+    std::cout << "\n--- Insert latency: ALL_AT_ONCE vs INCREMENTAL ---" << std::endl;
+    const int N = 1 << 20;
+    for (RehashMode mode : {RehashMode::ALL_AT_ONCE, RehashMode::INCREMENTAL}) {
+        HashTable<int> table(101, mode);
+        std::vector<long long> latencies(N);
+        for (int i = 0; i < N; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            table.insert(i);
+            auto end = std::chrono::steady_clock::now();
+            latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << (mode == RehashMode::ALL_AT_ONCE ? "ALL_AT_ONCE" : "INCREMENTAL")
+                  << ": p50=" << latencies[N / 2] << "ns p99=" << latencies[N / 100 * 99]
+                  << "ns p99.99=" << latencies[N / 10000 * 9999] << "ns max=" << latencies[N - 1] << "ns"
+                  << ", memory=" << static_cast<double>(table.memoryUsage()) / N << " bytes/element" << std::endl;
+    }
+
+    // 5. 容量策略对比：质数取模 vs 2 的幂 vs fastrange
+    std::cout << "\n--- Size policy benchmark ---" << std::endl;
+    std::vector<int> sequentialKeys(N), randomKeys(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        sequentialKeys[i] = 2 * i;
+        seed = seed * 1664525u + 1013904223u;
+        randomKeys[i] = static_cast<int>(seed & 0x7ffffffe);
+    }
+    std::cout << "Sequential keys:" << std::endl;
+    benchmarkSizePolicy<PrimeSizePolicy>("PrimeSizePolicy     ", sequentialKeys);
+    benchmarkSizePolicy<PowerOfTwoSizePolicy>("PowerOfTwoSizePolicy", sequentialKeys);
+    benchmarkSizePolicy<FastRangeSizePolicy>("FastRangeSizePolicy ", sequentialKeys);
+    std::cout << "Random keys:" << std::endl;
+    benchmarkSizePolicy<PrimeSizePolicy>("PrimeSizePolicy     ", randomKeys);
+    benchmarkSizePolicy<PowerOfTwoSizePolicy>("PowerOfTwoSizePolicy", randomKeys);
+    benchmarkSizePolicy<FastRangeSizePolicy>("FastRangeSizePolicy ", randomKeys);
+
+    // 6. 批量操作：逐个处理 vs 预取后批量处理，每批 256 个（join 中一次探测的典型批量）
+    std::cout << "\n--- Batch insert/lookup with prefetching ---" << std::endl;
+    std::vector<int> queries(2 * N);
+    for (int i = 0; i < 2 * N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        queries[i] = randomKeys[(seed >> 8) % N] | (i & 1);    // 奇数下标的查询一定不命中
+    }
+    benchmarkBatch<HashTable<int>>(randomKeys, queries, 256);
+
+    // 7. 异构查找、移动插入与 emplace
+    std::cout << "\n--- Heterogeneous lookup, move insert and emplace ---" << std::endl;
+    HashTable<std::string> names;
+    std::string longName = "a key that is too long for the small string buffer";
+    names.insert(std::move(longName));    // 移动插入，字符缓冲区直接转移到表中
+    names.emplace(5, 'x');                // 用 std::string(5, 'x') 的参数构造，即 "xxxxx"
+    std::string_view probe = "a key that is too long for the small string buffer";
+    std::cout << "Contains (string_view): " << (names.contains(probe) ? "Yes" : "No") << std::endl;
+    std::cout << "Contains (const char *) 'xxxxx': " << (names.contains("xxxxx") ? "Yes" : "No") << std::endl;
+    std::cout << "Removing 'xxxxx' by string_view: " << (names.remove(std::string_view("xxxxx")) ? "OK" : "Not found") << std::endl;
+    std::cout << "Size: " << names.size() << std::endl;
+    benchmarkHeterogeneousLookup<HashTable<std::string>>(1 << 16, 20);
+
+    // 8. 布隆过滤器：90% 的查找不命中
+    std::cout << "\n--- Bloom filter in front of lookups (90% misses) ---" << std::endl;
+    HashTable<int> filtered(7, RehashMode::INCREMENTAL);
+    filtered.enableBloomFilter();
+    for (int i = 0; i < 1000; ++i) {
+        filtered.insert(i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        filtered.remove(i);
+    }
+    int filteredHits = 0;
+    for (int i = 0; i < 10000; ++i) {
+        filteredHits += filtered.contains(i);
+    }
+    auto filterStats = filtered.bloomFilterStats();
+    std::cout << "Found " << filteredHits << " of 500 odd keys, filtered out " << filterStats.negatives << " misses, "
+              << filterStats.falsePositives << " false positives" << std::endl;
+    std::vector<int> missQueries(2 * N);
+    for (int i = 0; i < 2 * N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        missQueries[i] = (seed >> 8) % 10 == 0 ? randomKeys[(seed >> 4) % N] : static_cast<int>(seed | 1);
+    }
+    benchmarkBloomFilter(randomKeys, missQueries);
+
     return 0;
 }
+
+#endif    // SEP_CHAINING_NO_MAIN
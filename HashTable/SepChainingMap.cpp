@@ -0,0 +1,245 @@
+// 分离链接法的键值哈希表 HashMap<Key, Value>
+// SepChaining.cpp 中的 HashTable 只是集合，如果另外用一个结构按同样的 key 存 value，每次访问都要查两遍
+// 这里不重新实现一遍桶、结点池和渐进式 rehash，而是直接把键值对 MapEntry 作为 HashTable 的元素：
+//    1. MapEntry 的哈希和比较只看 key，value 不参与
+//    2. MapEntry 的哈希是透明的，可以直接用 key 去 find/remove，不需要构造一个完整的 MapEntry
+//    3. value 声明为 mutable：HashTable::find 返回的是 const 指针（元素的 key 决定了它在哪个桶里，不能改），
+//       但 value 不影响位置，可以放心修改
+// find 一次查找就拿到 value 的地址，既判断了存在性，又拿到了值
+
+// 存储布局：key 和 value 放在同一个 MapEntry 里，和桶的内联数组、溢出结点存在一起（相当于 ProbingHashMap.cpp 的 InterleavedLayout）
+// 分离链接法的元素会在 rehash 时在桶之间搬来搬去，没有固定的下标，所以不提供 key、value 分成两个数组的布局
+
+#define SEP_CHAINING_NO_MAIN
+#include "SepChaining.cpp"
+
+#include <array>
+
+// --- 键值对 ---
+
+template<class Key, class Value>
+struct MapEntry {
+    Key key;
+    mutable Value value;    // 不参与哈希和比较，可以通过 const 指针修改
+};
+
+// 两个键值对相等，当且仅当 key 相等
+template<class Key, class Value>
+bool operator==(const MapEntry<Key, Value> &lhs, const MapEntry<Key, Value> &rhs) {
+    return lhs.key == rhs.key;
+}
+
+// 键值对和一个 key（或者可以和 key 比较的类型，例如 string_view）比较
+template<class Key, class Value, class K>
+bool operator==(const MapEntry<Key, Value> &entry, const K &key) {
+    return entry.key == key;
+}
+
+// 键值对的哈希值就是 key 的哈希值，并且是透明的：HashTable 可以直接用 key 查找
+template<class Key, class Value>
+struct DefaultHash<MapEntry<Key, Value>> {
+    using is_transparent = void;
+
+    size_t operator()(const MapEntry<Key, Value> &entry) const {
+        return DefaultHash<Key>{}(entry.key);
+    }
+
+    template<class K>
+    size_t operator()(const K &key) const {
+        return DefaultHash<Key>{}(key);
+    }
+};
+
+// --- 模板类 `HashMap` ---
+
+template<class Key, class Value, class SizePolicy = PrimeSizePolicy>
+class HashMap {
+public:
+    using Entry = MapEntry<Key, Value>;
+
+    explicit HashMap(int initialSize = 101, RehashMode mode = RehashMode::ALL_AT_ONCE) : table(initialSize, mode) {}
+
+    // 查找 key，返回对应 value 的地址，不存在时返回 nullptr
+    // 返回的地址只在下一次操作之前有效（见 HashTable::find）
+    Value *find(const Key &key) {
+        const Entry *entry = table.find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    const Value *find(const Key &key) const {
+        const Entry *entry = table.find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    // 异构查找：Key 的哈希函数是透明的时候（例如 Key 为 std::string），可以直接用 string_view、const char * 查找
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    Value *find(const K &key) {
+        const Entry *entry = table.find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    const Value *find(const K &key) const {
+        const Entry *entry = table.find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    // 检查 key 是否存在
+    bool contains(const Key &key) const {
+        return table.find(key) != nullptr;
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    bool contains(const K &key) const {
+        return table.find(key) != nullptr;
+    }
+
+    // 插入键值对，key 已经存在时不覆盖，返回 false
+    bool insert(const Key &key, const Value &value) {
+        return table.insert(Entry{key, value});
+    }
+
+    // 插入键值对，key 已经存在时覆盖原来的 value。返回是否是新插入的
+    bool insertOrAssign(const Key &key, const Value &value) {
+        if (Value *existing = find(key)) {
+            *existing = value;
+            return false;
+        }
+        return table.insert(Entry{key, value});
+    }
+
+    // 返回 key 对应 value 的引用，key 不存在时先插入一个默认构造的 value
+    // 不存在时要查找、插入、再查找一次（插入可能触发 rehash，不能提前拿地址），存在时只查找一次
+    Value &operator[](const Key &key) {
+        if (Value *existing = find(key)) {
+            return *existing;
+        }
+        table.insert(Entry{key, Value()});
+        return *find(key);
+    }
+
+    // 删除 key
+    bool remove(const Key &key) {
+        return table.remove(key);
+    }
+
+    template<class K, class Hash = DefaultHash<Key>, class = typename Hash::is_transparent>
+    bool remove(const K &key) {
+        return table.remove(key);
+    }
+
+    // 清空
+    void makeEmpty() {
+        table.makeEmpty();
+    }
+
+    // 获取键值对的数量
+    int size() const {
+        return table.size();
+    }
+
+    // 获取桶的数量
+    int bucketCount() const {
+        return table.bucketCount();
+    }
+
+    // 估算占用的内存（字节），不包含 key、value 自己在堆上持有的内存
+    size_t memoryUsage() const {
+        return table.memoryUsage();
+    }
+
+private:
+    HashTable<Entry, SizePolicy> table;
+};
+
+// --- 性能对比 ---
+
+// 一个比较大的 value：64 字节
+struct Record {
+    long long id = 0;
+    std::array<char, 56> payload{};
+};
+
+// --- 主函数测试 ---
+
+int main() {
+    // 1. 基本功能
+    std::cout << "--- Testing HashMap<std::string, int> ---" << std::endl;
+    HashMap<std::string, int> wordCount(7);
+    for (const char *word : {"apple", "banana", "apple", "cherry", "banana", "apple"}) {
+        wordCount[word]++;
+    }
+    std::cout << "apple: " << *wordCount.find("apple") << ", banana: " << *wordCount.find(std::string_view("banana"))
+              << ", cherry: " << wordCount["cherry"] << std::endl;
+    std::cout << "Contains 'grape': " << (wordCount.contains("grape") ? "Yes" : "No") << std::endl;
+    std::cout << "insert('apple', 100): " << (wordCount.insert("apple", 100) ? "inserted" : "kept") << ", apple: " << wordCount["apple"]
+              << std::endl;
+    std::cout << "insertOrAssign('apple', 100): " << (wordCount.insertOrAssign("apple", 100) ? "inserted" : "assigned")
+              << ", apple: " << wordCount["apple"] << std::endl;
+    std::cout << "Removing 'banana': " << (wordCount.remove("banana") ? "OK" : "Not found") << std::endl;
+    std::cout << "Find 'banana': " << (wordCount.find("banana") == nullptr ? "nullptr" : "found") << std::endl;
+    std::cout << "Size: " << wordCount.size() << ", buckets: " << wordCount.bucketCount() << std::endl;
+
+    // 2. 渐进式 rehash 模式下的正确性：和一次性 rehash 的结果应该完全一致
+    std::cout << "\n--- Churn check (both rehash modes) ---" << std::endl;
+    HashMap<int, int> allAtOnce;
+    HashMap<int, int> incremental(101, RehashMode::INCREMENTAL);
+    for (int i = 0; i < 20000; ++i) {
+        allAtOnce[i % 5000] += i;
+        incremental[i % 5000] += i;
+        if (i % 3 == 0) {
+            allAtOnce.remove(i % 7000);
+            incremental.remove(i % 7000);
+        }
+    }
+    bool ok = allAtOnce.size() == incremental.size();
+    for (int i = 0; i < 7000; ++i) {
+        const int *a = allAtOnce.find(i);
+        const int *b = incremental.find(i);
+        ok &= (a == nullptr) == (b == nullptr) && (a == nullptr || *a == *b);
+    }
+    std::cout << "Size: " << allAtOnce.size() << ", modes agree: " << (ok ? "OK" : "FAILED") << std::endl;
+
+    // 3. 一次查找取值 vs 集合 + 另一张存 value 的表（查两遍）
+    std::cout << "\n--- Map lookup vs set + map (64-byte values) ---" << std::endl;
+    const int N = 1 << 19;
+    std::vector<int> keys(N), queries(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        keys[i] = static_cast<int>(seed & 0x7ffffffe);
+    }
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        queries[i] = keys[(seed >> 8) % N];
+    }
+    HashTable<int> keySet;
+    HashMap<int, Record> values;
+    for (int k : keys) {
+        keySet.insert(k);
+        values.insert(k, Record{k, {}});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long long mapSum = 0;
+    for (int q : queries) {
+        if (const Record *r = values.find(q)) {
+            mapSum += r->id;
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    long long setSum = 0;
+    for (int q : queries) {
+        if (keySet.contains(q)) {
+            setSum += values.find(q)->id;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "  map find : " << std::chrono::duration<double, std::milli>(middle - start).count() << " ms (checksum " << mapSum
+              << ")" << std::endl;
+    std::cout << "  set + map: " << std::chrono::duration<double, std::milli>(end - middle).count() << " ms (checksum " << setSum
+              << ")" << std::endl;
+    std::cout << "  memory: " << values.memoryUsage() / (1024 * 1024) << " MB" << std::endl;
+
+    return 0;
+}
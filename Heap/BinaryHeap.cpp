@@ -7,6 +7,17 @@
 // 层序遍历形成的数组，对于二叉树来说，有一个特点：
 // 对于一个节点 i，其左子节点的索引为 2*i，右子节点的索引为 2*i + 1，父节点的索引为 i/2
 
+// d 叉堆（d-ary heap）：每个节点有 d 个子节点，下标从 0 开始时，节点 i 的子节点为 d*i + 1 ~ d*i + d，父节点为 (i - 1) / d
+// 树高从 log2(n) 降到 logd(n)：
+//    - 上浮（插入）只和父节点比较，层数少了，插入更快
+//    - 下沉（删除最小）每层要在 d 个子节点中找最小的，比较次数变多，但 d 个子节点在数组中是连续的，
+//      d = 4 时 4 个 int 在同一个 cache line 里，一层只有一次 cache miss，层数却少了一半
+// 所以 d = 4 通常比二叉堆更快，d 太大时每层的比较次数又会占上风，见 main 中的对比
+
+// 建堆（Floyd 算法）：
+// 逐个 insert 建堆是 O(n log n)。Floyd 的做法是先把 n 个元素原样放进数组，再从最后一个非叶子节点开始往前，逐个下沉
+// 一半的节点是叶子，不用动；高度为 h 的节点至多 n / d^(h+1) 个，每个下沉至多 h 层，求和是 O(n)
+
 // 应用1：优先队列（Priority Queue）
 // 每次取根结点，然后将最后一个元素放到根结点位置，然后下沉
 
@@ -18,81 +29,120 @@
 // 根节点与末尾元素交换，然后下沉新根节点，直到堆的性质满足，然后重复执行，直到堆为空，序列就是有序的
 // 但如果处理乱序数组，需要先把数组构建成一个堆，然后再进行排序
 
-#include <algorithm>    // 用于 std::swap
+#include <algorithm>    // 用于 std::min
+#include <chrono>
+#include <functional>   // 用于 std::less
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 // 定义MinHeap类
+// T 是元素类型，Compare 是比较函数（默认 std::less，即最小堆；换成 std::greater 就是最大堆），D 是每个节点的子节点个数
+template<class T, class Compare = std::less<T>, int D = 2>
 class MinHeap {
+    static_assert(D >= 2, "a heap node needs at least 2 children");
+
 private:
-    std::vector<int> heap;    // 使用vector来存储堆元素
+    std::vector<T> heap;    // 使用vector来存储堆元素
+    Compare comp;           // comp(a, b) 为 true 表示 a 应该在 b 的上面
 
     // 上浮操作：当新元素插入或元素值减小时，维持堆的性质
-    void heapifyUp(int index) {
-        // 当当前节点不是根节点且小于其父节点时，进行交换
-        while (index > 0 && heap[index] < heap[parent(index)]) {
-            std::swap(heap[index], heap[parent(index)]);
+    // 不逐层交换，而是把要上浮的元素先拿出来，留下一个“空穴”（hole）：
+    // 父节点比它大，就把父节点移到空穴里，空穴上移一层；最后把元素放进空穴
+    // 一次交换是 3 次赋值，这样每层只有 1 次移动
+    void heapifyUp(size_t index) {
+        T value = std::move(heap[index]);
+        // 当当前节点不是根节点且小于其父节点时，父节点下移
+        while (index > 0 && comp(value, heap[parent(index)])) {
+            heap[index] = std::move(heap[parent(index)]);
             index = parent(index);    // 更新索引到父节点的位置
         }
+        heap[index] = std::move(value);
     }
 
     // 下沉操作：当根元素被删除或元素值增大时，维持堆的性质
-    void heapifyDown(int index) {
-        int smallest = index;    // 假设当前节点是最小的
-        int leftChild = left(index);
-        int rightChild = right(index);
-
-        // 要找到左右子节点中最小的一个与当前父节点交换，所以下面两个if是合法的
-
-        // 如果左子节点存在且小于当前最小节点
-        if (leftChild < heap.size() && heap[leftChild] < heap[smallest]) {
-            smallest = leftChild;
+    // 同样使用空穴：每层在 D 个子节点中找到最小的，它比要下沉的元素小，就上移到空穴里，空穴下移一层
+    // 用循环代替递归，不会因为堆很大而占用很深的调用栈
+    void heapifyDown(size_t index) {
+        size_t n = heap.size();
+        T value = std::move(heap[index]);
+        while (true) {
+            size_t first = firstChild(index);
+            if (first >= n) {
+                break;    // 叶子节点
+            }
+            // 要找到所有子节点中最小的一个，相等时取最左边的
+            size_t last = std::min(first + D, n);
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (comp(heap[child], heap[smallest])) {
+                    smallest = child;
+                }
+            }
+            // 最小的子节点也不比当前元素小，堆的性质已经满足
+            if (!comp(heap[smallest], value)) {
+                break;
+            }
+            heap[index] = std::move(heap[smallest]);
+            index = smallest;
         }
+        heap[index] = std::move(value);
+    }
 
-        // 如果右子节点存在且小于当前最小节点
-        if (rightChild < heap.size() && heap[rightChild] < heap[smallest]) {
-            smallest = rightChild;
+    // Floyd 建堆：从最后一个非叶子节点（最后一个元素的父节点）开始往前逐个下沉，O(n)
+    void buildHeap() {
+        if (heap.size() < 2) {
+            return;
         }
-
-        // 如果最小节点不是当前节点，则交换并递归下沉
-        if (smallest != index) {
-            std::swap(heap[index], heap[smallest]);
-            heapifyDown(smallest);    // 递归调用，继续下沉
+        for (size_t i = parent(heap.size() - 1) + 1; i-- > 0;) {
+            heapifyDown(i);
         }
     }
 
     // 获取父节点的索引
-    int parent(int i) {
-        return (i - 1) / 2;
+    static size_t parent(size_t i) {
+        return (i - 1) / D;
     }
 
-    // 获取左子节点的索引
-    // 注意：这里的左子节点索引是从0开始的，所以是2*i + 1
-    // 如果是从1开始的完全二叉树，则是2*i
-    int left(int i) {
-        return (2 * i + 1);
-    }
-
-    // 获取右子节点的索引
-    // 注意：这里的右子节点索引是从0开始的，所以是2*i + 2
-    // 如果是从1开始的完全二叉树，则是2*i + 1
-    int right(int i) {
-        return (2 * i + 2);
+    // 获取第一个子节点的索引，其余子节点紧随其后
+    // 注意：这里的索引是从0开始的，二叉堆时就是左子节点 2*i + 1，右子节点 2*i + 2
+    // 如果是从1开始的完全二叉树，则是2*i 和 2*i + 1
+    static size_t firstChild(size_t i) {
+        return D * i + 1;
     }
 
 public:
     // 构造函数
-    MinHeap() {}
+    explicit MinHeap(const Compare &compare = Compare()) : comp(compare) {}
+
+    // 用 [first, last) 中的元素建堆，O(n)（逐个 insert 是 O(n log n)）
+    template<class InputIt>
+    MinHeap(InputIt first, InputIt last, const Compare &compare = Compare()) : heap(first, last), comp(compare) {
+        buildHeap();
+    }
+
+    // 预先分配能放下 capacity 个元素的空间，元素个数不超过它时 insert 不会再扩容
+    void reserve(size_t capacity) {
+        heap.reserve(capacity);
+    }
 
     // 插入元素
     // 插入到vector的末尾，然后进行上浮操作。上浮比下浮更简单
-    void insert(int value) {
+    void insert(const T &value) {
         heap.push_back(value);         // 将新元素添加到vector末尾
         heapifyUp(heap.size() - 1);    // 对新元素进行上浮操作
     }
 
+    // 插入元素（移动版本）
+    void insert(T &&value) {
+        heap.push_back(std::move(value));
+        heapifyUp(heap.size() - 1);
+    }
+
     // 获取堆中最小元素（即根元素）
-    int peek() {
+    const T &peek() const {
         if (isEmpty()) {
             throw std::runtime_error("Heap is empty. Cannot peek.");
         }
@@ -100,13 +150,15 @@ public:
     }
 
     // 删除并返回堆中最小元素
-    int extractMin() {
+    T extractMin() {
         if (isEmpty()) {
             throw std::runtime_error("Heap is empty. Cannot extract min.");
         }
-        int min_val = heap[0];    // 保存最小元素
+        T min_val = std::move(heap[0]);    // 保存最小元素
         // 将最后一个元素移动到根部，然后删除最后一个元素
-        heap[0] = heap.back();
+        if (heap.size() > 1) {
+            heap[0] = std::move(heap.back());
+        }
         heap.pop_back();
         // 如果堆不为空，对新的根元素进行下沉操作
         if (!isEmpty()) {
@@ -115,21 +167,39 @@ public:
         return min_val;
     }
 
+    // 用 value 替换堆顶，返回原来的堆顶
+    // 等价于 extractMin() 再 insert(value)，但只做一次下沉：
+    // 先弹出再压入要把末尾元素挪到根下沉一次、新元素再从末尾上浮一次，这里直接把 value 放在根上下沉
+    // top-k、k 路归并这类“弹一个、进一个”的场景，堆的大小不变，用它正好
+    T replaceTop(const T &value) {
+        return replaceTop(T(value));
+    }
+
+    T replaceTop(T &&value) {
+        if (isEmpty()) {
+            throw std::runtime_error("Heap is empty. Cannot replace top.");
+        }
+        T top = std::move(heap[0]);
+        heap[0] = std::move(value);
+        heapifyDown(0);
+        return top;
+    }
+
     // 检查堆是否为空
-    bool isEmpty() {
+    bool isEmpty() const {
         return heap.empty();
     }
 
     // 获取堆中元素的数量
-    int size() {
+    int size() const {
         return heap.size();
     }
 
     // 打印堆的所有元素 (按内部存储顺序)
     // 常量引用才能给默认参数，普通左值引用不可以
-    void printHeap(const std::string &info = "Heap elements (internal order):") {
+    void printHeap(const std::string &info = "Heap elements (internal order):") const {
         std::cout << info;
-        for (int val : heap) {
+        for (const T &val : heap) {
             std::cout << val << " ";
         }
         std::cout << std::endl;
@@ -142,18 +212,253 @@ public:
     // 不过，在排序之后，一旦执行新的插入操作等，升序性质就会破坏
     // 本来这里的堆排序就是演示性质而已，升序性质本来就是不用维护的
     void heapSort() {
-        std::vector<int> sorted;
+        std::vector<T> sorted;
         while (!isEmpty()) {
             sorted.push_back(extractMin());    // 依次提取最小元素
         }
-        heap = sorted;                         // 将排序后的结果赋值回堆
+        heap = std::move(sorted);              // 将排序后的结果赋值回堆
         // 打印排序后的结果
         printHeap("Sorted elements:");
     }
 };
 
+// --- 索引堆 ---
+
+// 索引最小堆（indexed / addressable heap）：堆中的元素是 [0, capacity) 范围内的编号（例如图的顶点号），每个编号带一个 key
+// 普通的堆只能拿到堆顶，想修改某个元素的 key 只能再插入一份新的，旧的留在堆里，弹出时再跳过（惰性删除）
+// 索引堆额外维护一个位置表 pos：pos[id] 是编号 id 在堆数组中的下标（不在堆中为 -1），每次移动元素时同步更新
+// 有了位置表，就能直接找到某个编号在堆中的位置，decreaseKey、erase 都是 O(log n)，contains 是 O(1)
+// 堆中每个编号最多出现一次，堆的大小不超过 capacity
+// 用法（Dijkstra 的松弛）：dist 变小时调用 insertOrDecrease，堆中始终只有每个顶点的最新距离
+template<class Key, class Compare = std::less<Key>, int D = 2>
+class IndexedMinHeap {
+    static_assert(D >= 2, "a heap node needs at least 2 children");
+
+private:
+    std::vector<int> heap;    // 堆数组，存放编号
+    std::vector<int> pos;     // 位置表：pos[id] 为编号 id 在 heap 中的下标，不在堆中时为 -1
+    std::vector<Key> keys;    // keys[id] 为编号 id 的 key，只有在堆中的编号才有意义
+    Compare comp;
+
+    // 把编号 id 放到堆数组的下标 index 上，同时更新位置表
+    void place(size_t index, int id) {
+        heap[index] = id;
+        pos[id] = static_cast<int>(index);
+    }
+
+    // 上浮，和 MinHeap 一样使用空穴，每次移动都要同步更新位置表
+    void heapifyUp(size_t index) {
+        int id = heap[index];
+        while (index > 0 && comp(keys[id], keys[heap[parent(index)]])) {
+            place(index, heap[parent(index)]);
+            index = parent(index);
+        }
+        place(index, id);
+    }
+
+    // 下沉
+    void heapifyDown(size_t index) {
+        size_t n = heap.size();
+        int id = heap[index];
+        while (true) {
+            size_t first = firstChild(index);
+            if (first >= n) {
+                break;
+            }
+            size_t last = std::min(first + D, n);
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (comp(keys[heap[child]], keys[heap[smallest]])) {
+                    smallest = child;
+                }
+            }
+            if (!comp(keys[heap[smallest]], keys[id])) {
+                break;
+            }
+            place(index, heap[smallest]);
+            index = smallest;
+        }
+        place(index, id);
+    }
+
+    // 删除堆数组下标 index 上的元素：用最后一个元素填上，再视情况上浮或下沉
+    void removeAt(size_t index) {
+        pos[heap[index]] = -1;
+        int lastId = heap.back();
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(index, lastId);
+            // 填进来的元素可能比原来的小（要上浮），也可能比原来的大（要下沉），二者只会发生一个
+            heapifyUp(index);
+            heapifyDown(pos[lastId]);
+        }
+    }
+
+    static size_t parent(size_t i) {
+        return (i - 1) / D;
+    }
+
+    static size_t firstChild(size_t i) {
+        return D * i + 1;
+    }
+
+    void checkId(int id) const {
+        if (id < 0 || id >= static_cast<int>(pos.size())) {
+            throw std::out_of_range("IndexedMinHeap: id out of range.");
+        }
+    }
+
+public:
+    // 编号的范围是 [0, capacity)，位置表和 key 表一次分配好，之后不再增长
+    explicit IndexedMinHeap(int capacity, const Compare &compare = Compare())
+        : pos(capacity, -1), keys(capacity), comp(compare) {
+        heap.reserve(capacity);
+    }
+
+    // 检查编号 id 是否在堆中，O(1)
+    bool contains(int id) const {
+        checkId(id);
+        return pos[id] != -1;
+    }
+
+    // 插入编号 id，它的 key 为 key。id 已经在堆中时抛出异常
+    void insert(int id, const Key &key) {
+        if (contains(id)) {
+            throw std::invalid_argument("IndexedMinHeap: id is already in the heap.");
+        }
+        keys[id] = key;
+        heap.push_back(id);
+        pos[id] = static_cast<int>(heap.size() - 1);
+        heapifyUp(heap.size() - 1);
+    }
+
+    // 把编号 id 的 key 减小为 key（只能减小，新 key 更大时抛出异常），O(log n)
+    void decreaseKey(int id, const Key &key) {
+        if (!contains(id)) {
+            throw std::invalid_argument("IndexedMinHeap: id is not in the heap.");
+        }
+        if (comp(keys[id], key)) {
+            throw std::invalid_argument("IndexedMinHeap: decreaseKey cannot increase a key.");
+        }
+        keys[id] = key;
+        heapifyUp(pos[id]);
+    }
+
+    // id 不在堆中时插入；在堆中且 key 更小时减小它的 key。返回堆是否被修改
+    bool insertOrDecrease(int id, const Key &key) {
+        if (!contains(id)) {
+            insert(id, key);
+            return true;
+        }
+        if (comp(key, keys[id])) {
+            keys[id] = key;
+            heapifyUp(pos[id]);
+            return true;
+        }
+        return false;
+    }
+
+    // 从堆中删除编号 id，不在堆中时返回 false，O(log n)
+    bool erase(int id) {
+        if (!contains(id)) {
+            return false;
+        }
+        removeAt(pos[id]);
+        return true;
+    }
+
+    // 编号 id 当前的 key，id 必须在堆中
+    const Key &keyOf(int id) const {
+        if (!contains(id)) {
+            throw std::invalid_argument("IndexedMinHeap: id is not in the heap.");
+        }
+        return keys[id];
+    }
+
+    // 堆顶（key 最小）的编号
+    int peekId() const {
+        if (isEmpty()) {
+            throw std::runtime_error("Heap is empty. Cannot peek.");
+        }
+        return heap[0];
+    }
+
+    // 堆顶的 key
+    const Key &peekKey() const {
+        return keys[peekId()];
+    }
+
+    // 删除堆顶，返回它的编号（它的 key 可以在删除前用 peekKey 取得）
+    int extractMin() {
+        int id = peekId();
+        removeAt(0);
+        return id;
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    // 编号的范围
+    int capacity() const {
+        return pos.size();
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 MinHeap 和 IndexedMinHeap
+// 它们在 #include 之前定义 BINARY_HEAP_NO_MAIN，跳过下面的测试代码和 main
+#ifndef BINARY_HEAP_NO_MAIN
+
+// --- 性能对比 ---
+
+// 同一组随机数，用 D 叉堆测试：
+//    1. 逐个 insert 建堆 vs Floyd 建堆
+//    2. push/pop 交替（优先队列的典型用法：堆大小保持不变，每次弹出一个再压入一个）
+//    3. 全部弹出
+template<int D>
+void benchmarkArity(const std::vector<int> &values) {
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    MinHeap<int, std::less<int>, D> inserted;
+    for (int v : values) {
+        inserted.insert(v);
+    }
+    auto insertDone = std::chrono::steady_clock::now();
+    MinHeap<int, std::less<int>, D> heap(values.begin(), values.end());
+    auto buildDone = std::chrono::steady_clock::now();
+
+    long long checksum = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        int top = heap.extractMin();
+        checksum += top;
+        heap.insert(top + values[i] % 1024);
+    }
+    auto pushPopDone = std::chrono::steady_clock::now();
+
+    bool sorted = true;
+    int previous = heap.extractMin();
+    while (!heap.isEmpty()) {
+        int current = heap.extractMin();
+        sorted &= previous <= current;
+        previous = current;
+    }
+    auto drainDone = std::chrono::steady_clock::now();
+
+    double mops = values.size() / ms(buildDone, pushPopDone) / 1000.0;
+    std::cout << "  D = " << D << ": insert-build " << ms(start, insertDone) << " ms, Floyd build " << ms(insertDone, buildDone)
+              << " ms, push/pop " << ms(buildDone, pushPopDone) << " ms (" << mops << " M pairs/s), drain "
+              << ms(pushPopDone, drainDone) << " ms, " << (sorted ? "sorted" : "NOT SORTED") << ", checksum " << checksum << std::endl;
+}
+
 int main() {
-    MinHeap minHeap;
+    MinHeap<int> minHeap;
 
     std::cout << "--- MinHeap 功能测试 ---" << std::endl;
 
@@ -219,5 +524,45 @@ int main() {
     minHeap.printHeap();
     std::cout << "Current min element: " << minHeap.peek() << std::endl;
 
+    // 7. 从数组建堆（Floyd），以及用 std::greater 得到最大堆
+    std::vector<int> values = {9, 4, 7, 1, 8, 2, 6, 3, 5};
+    MinHeap<int, std::less<int>, 4> built(values.begin(), values.end());
+    built.printHeap("\n4-ary heap built from {9, 4, 7, 1, 8, 2, 6, 3, 5}: ");
+    MinHeap<int, std::greater<int>> maxHeap(values.begin(), values.end());
+    std::cout << "Max heap top: " << maxHeap.peek() << std::endl;
+
+    // 8. 不同叉数的性能对比
+    std::cout << "\n--- D-ary heap benchmark (2^22 random ints) ---" << std::endl;
+    const int N = 1 << 22;
+    std::vector<int> randomValues(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        randomValues[i] = static_cast<int>(seed >> 2);
+    }
+    benchmarkArity<2>(randomValues);
+    benchmarkArity<4>(randomValues);
+    benchmarkArity<8>(randomValues);
+
+    // 9. 索引堆：decreaseKey 和 erase
+    std::cout << "\n--- IndexedMinHeap ---" << std::endl;
+    IndexedMinHeap<int> indexed(6);
+    int initialKeys[] = {50, 30, 40, 10, 20, 60};
+    for (int id = 0; id < 6; ++id) {
+        indexed.insert(id, initialKeys[id]);
+    }
+    indexed.decreaseKey(5, 5);    // 编号 5 的 key 从 60 减小到 5，成为堆顶
+    indexed.erase(3);             // 删除编号 3（key 10）
+    std::cout << "Contains 3: " << (indexed.contains(3) ? "Yes" : "No") << ", key of 2: " << indexed.keyOf(2) << std::endl;
+    std::cout << "Extract order (id:key): ";
+    while (!indexed.isEmpty()) {
+        int key = indexed.peekKey();
+        int id = indexed.extractMin();
+        std::cout << id << ":" << key << " ";
+    }
+    std::cout << std::endl;
+
     return 0;
 }
+
+#endif    // BINARY_HEAP_NO_MAIN
@@ -17,9 +17,21 @@
 
 // 关于二项树的结构与二项式定理的关系，在deleteMin方法中有讲解
 
+// 节点的分配：
+// 每个节点单独 new 的话，百万级元素时 new/delete 本身就是主要开销，节点散落在堆上，遍历指针也容易 cache miss
+// 这里改为从节点池（NodePool）里分配：池按块（slab）向系统申请内存，块内连续切分出节点，释放的节点挂到空闲链表上复用
+// 1. 每个队列默认有自己的池。清空或析构时，如果池只被这一个队列使用，直接整池重置，不需要逐个释放节点
+// 2. 多个队列可以共用一个池（构造时传入同一个池）。共用池的队列之间 merge 只是挂指针，不复制节点
+//    池不同的队列 merge 时，rhs 的节点属于别的池，只能复制到本队列的池中
+// 3. 清空和拷贝都不用递归，不会因为树深而爆栈
+
 #include <algorithm>    // For std::max
+#include <chrono>
 #include <iostream>
+#include <memory>         // For std::shared_ptr
+#include <new>            // For placement new
 #include <stdexcept>    // For std::underflow_error
+#include <type_traits>    // For std::is_trivially_destructible
 #include <vector>
 
 template<class Comparable>
@@ -37,6 +49,101 @@ private:
             : element(theElement), leftChild(lc), nextSibling(ns) {}
     };
 
+public:
+    // --- 节点池 ---
+    // 按块分配节点内存，块的大小从 64 个节点开始翻倍，最大 65536 个节点
+    // 块只在池析构时归还系统；reset() 之后块里的内存从头开始重新切分
+    class NodePool {
+    private:
+        // 空闲时存放空闲链表的指针，使用时存放节点
+        union Slot {
+            Slot *next;
+            BinomialNode node;
+
+            Slot() {}
+            ~Slot() {}
+        };
+
+        static constexpr int FIRST_SLAB_NODES = 64;
+        static constexpr int MAX_SLAB_NODES = 65536;
+
+        std::vector<std::unique_ptr<Slot[]>> slabs;
+        std::vector<int> slabSizes;
+        size_t currentSlab;  // 正在切分的块
+        int usedInSlab;      // 当前块已经切出去的节点数
+        Slot *freeList;      // 释放后可复用的节点
+        int liveNodes;       // 正在使用的节点数
+
+        Slot *takeSlot() {
+            if (freeList != nullptr) {
+                Slot *slot = freeList;
+                freeList = freeList->next;
+                return slot;
+            }
+            while (currentSlab < slabs.size() && usedInSlab == slabSizes[currentSlab]) {
+                ++currentSlab;
+                usedInSlab = 0;
+            }
+            if (currentSlab == slabs.size()) {
+                int nodes = slabSizes.empty() ? FIRST_SLAB_NODES : std::min(slabSizes.back() * 2, MAX_SLAB_NODES);
+                slabs.emplace_back(new Slot[nodes]);
+                slabSizes.push_back(nodes);
+            }
+            return &slabs[currentSlab][usedInSlab++];
+        }
+
+    public:
+        NodePool() : currentSlab(0), usedInSlab(0), freeList(nullptr), liveNodes(0) {}
+
+        NodePool(const NodePool &) = delete;
+        NodePool &operator=(const NodePool &) = delete;
+
+        BinomialNode *allocate(const Comparable &x) {
+            Slot *slot = takeSlot();
+            try {
+                new (&slot->node) BinomialNode(x);
+            } catch (...) {
+                slot->next = freeList;    // 元素的拷贝构造抛异常时，把位置还回去
+                freeList = slot;
+                throw;
+            }
+            ++liveNodes;
+            return &slot->node;
+        }
+
+        void deallocate(BinomialNode *node) {
+            node->~BinomialNode();
+            // node 是 Slot 的唯一使用中的成员，地址和 Slot 相同
+            Slot *slot = reinterpret_cast<Slot *>(node);
+            slot->next = freeList;
+            freeList = slot;
+            --liveNodes;
+        }
+
+        // 一次性作废池里的所有节点，不调用元素的析构函数，调用者要保证这些节点已经不再使用
+        void reset() {
+            currentSlab = 0;
+            usedInSlab = 0;
+            freeList = nullptr;
+            liveNodes = 0;
+        }
+
+        int liveCount() const {
+            return liveNodes;
+        }
+
+        // 向系统申请的总字节数
+        size_t memoryUsage() const {
+            size_t nodes = 0;
+            for (int n : slabSizes) {
+                nodes += n;
+            }
+            return nodes * sizeof(Slot);
+        }
+    };
+
+private:
+
     // --- 私有成员变量 ---
     // 向量的索引 'i' 对应二项树的阶数（order）或高度（height）。
     // theTrees[i] 存储的是一棵阶数为 'i' 的二项树的根节点。
@@ -45,6 +152,8 @@ private:
     int currentSize;                         // 记录整个二项队列中所有二项树的节点总数，并不是二项树的数目
                                              // 给定currentSize，将其转换为二进制数，就可以判断出具体包含哪些二项树了
     std::vector<BinomialNode *> theTrees;    // 存储所有二项树的根节点
+    std::shared_ptr<NodePool> pool;          // 节点从这里分配，可能和其他队列共用
+    std::vector<BinomialNode *> childTrees;  // deleteMin 拆出来的子树，作为成员复用，避免每次分配
     enum class TreeNum {
         DEFAULT_TREES = 1
     };    // 默认的二项树数量
@@ -118,34 +227,61 @@ private:
         return t1;    // 返回新合并树的根节点
     }
 
-    // 递归地清空（删除所有节点）一棵二项树，熟悉的后序遍历
-    // 这是深层清理，用于析构函数和 makeEmpty() 方法。
-    void makeEmpty(BinomialNode *&t) {
-        if (t != nullptr) {
-            makeEmpty(t->leftChild);      // 递归清空当前节点的左子树（即更高阶数的子树）
-            makeEmpty(t->nextSibling);    // 递归清空当前节点的兄弟子树（即同层级的其他树）
-            delete t;                     // 删除当前节点
-            t = nullptr;                  // 将指针置空，避免悬空指针
+    // 清空一棵二项树，不用递归
+    // 把 leftChild / nextSibling 看成二叉树的左右孩子：有左孩子就右旋，把左孩子转到上面；没有左孩子就处理当前节点，走向右孩子
+    // 每次右旋都让一个节点离开左链，所以总共 O(n)，也不需要额外的栈
+    // destroyOnly 为 true 时只析构元素，不把节点还给池（之后会整池 reset）
+    void makeEmpty(BinomialNode *&t, bool destroyOnly) {
+        BinomialNode *curr = t;
+        while (curr != nullptr) {
+            if (curr->leftChild == nullptr) {
+                BinomialNode *next = curr->nextSibling;
+                if (destroyOnly) {
+                    curr->~BinomialNode();
+                } else {
+                    pool->deallocate(curr);
+                }
+                curr = next;
+            } else {
+                BinomialNode *child = curr->leftChild;
+                curr->leftChild = child->nextSibling;
+                child->nextSibling = curr;
+                curr = child;
+            }
         }
+        t = nullptr;    // 将指针置空，避免悬空指针
     }
 
-    // 递归地克隆一棵二项树。
-    // 用于拷贝构造函数和赋值运算符，实现深拷贝。
-    // 根据递归树，只有空节点会进入递归出口，叶子结点可以顺利执行clone
-    // 实际上，这是一个后序遍历的模型。也很符合直觉，必须现有孩子才能有父母
-    BinomialNode *clone(BinomialNode *t) const {
+    // 把 t 克隆到本队列的池里，用于拷贝和跨池的 merge
+    // 不用递归：用一个栈保存“已经复制了节点本身、还没复制孩子和兄弟”的节点对
+    BinomialNode *clone(BinomialNode *t) {
         if (t == nullptr) {
             return nullptr;
         }
-        // 创建一个新节点，并递归地克隆其子节点和兄弟节点。
-        return new BinomialNode(t->element, clone(t->leftChild), clone(t->nextSibling));
+        BinomialNode *copyRoot = pool->allocate(t->element);
+        std::vector<std::pair<BinomialNode *, BinomialNode *>> pending;    // (原节点, 副本)
+        pending.push_back({t, copyRoot});
+        while (!pending.empty()) {
+            BinomialNode *src = pending.back().first;
+            BinomialNode *dst = pending.back().second;
+            pending.pop_back();
+            if (src->leftChild != nullptr) {
+                dst->leftChild = pool->allocate(src->leftChild->element);
+                pending.push_back({src->leftChild, dst->leftChild});
+            }
+            if (src->nextSibling != nullptr) {
+                dst->nextSibling = pool->allocate(src->nextSibling->element);
+                pending.push_back({src->nextSibling, dst->nextSibling});
+            }
+        }
+        return copyRoot;
     }
 
 public:
     // --- 构造函数与析构函数 ---
 
-    // 默认构造函数：创建一个空的二项队列。
-    BinomialQueue() : currentSize(0) {
+    // 默认构造函数：创建一个空的二项队列，使用自己的节点池。
+    BinomialQueue() : currentSize(0), pool(std::make_shared<NodePool>()) {
         // 预留一些初始空间，避免频繁的向量重新分配，但 `currentSize` 仍然是 0。
         // DEFAULT_TREES 设定为 1 或 2 通常足够。
         theTrees.reserve(static_cast<size_t>(TreeNum::DEFAULT_TREES));
@@ -153,12 +289,20 @@ public:
 
     // 带初始元素的构造函数：创建一个包含一个元素的二项队列。
     // 内部调用 insert 方法，因为它能正确处理队列的合并和结构维护。
-    explicit BinomialQueue(const Comparable &item) : currentSize(0) {
+    explicit BinomialQueue(const Comparable &item) : currentSize(0), pool(std::make_shared<NodePool>()) {
         insert(item);
     }
 
+    // 使用给定的节点池创建空队列。共用同一个池的队列之间 merge 不需要复制节点
+    explicit BinomialQueue(std::shared_ptr<NodePool> sharedPool) : currentSize(0), pool(std::move(sharedPool)) {
+        if (pool == nullptr) {
+            throw std::invalid_argument("BinomialQueue: node pool must not be null.");
+        }
+    }
+
     // 拷贝构造函数：执行深拷贝，复制另一个二项队列的所有树结构。
-    BinomialQueue(const BinomialQueue &rhs) : currentSize(0) {
+    // 副本使用自己的节点池，不和 rhs 共用
+    BinomialQueue(const BinomialQueue &rhs) : currentSize(0), pool(std::make_shared<NodePool>()) {
         // 利用拷贝赋值运算符来执行深拷贝，避免代码重复。
         *this = rhs;
     }
@@ -175,6 +319,15 @@ public:
         return currentSize == 0;
     }
 
+    int size() const {
+        return currentSize;
+    }
+
+    // 本队列使用的节点池，可以传给其他队列的构造函数来共用
+    std::shared_ptr<NodePool> nodePool() const {
+        return pool;
+    }
+
     // 返回二项队列中的最小元素。
     // 如果队列为空，则抛出 std::underflow_error 异常。
     const Comparable &findMin() const {
@@ -187,18 +340,24 @@ public:
     }
 
     // 向二项队列中插入一个新元素。
-    // 实现方式是创建一个只包含新元素的临时二项队列（实际上是一棵 B0 树），
-    // 然后将其与当前队列合并。
-    // 注意合并方法不是把二项树合并到二项队列，而是把二项队列合并到二项队列
+    // 相当于和一个只包含新元素的二项队列（一棵 B0 树）合并，也就是二进制加 1：
+    // 从第 0 位开始，这一位有树就合并成进位继续往上，直到遇到空位
+    // 不真的构造临时队列，省掉临时队列的 vector 和节点池
     void insert(const Comparable &x) {
-        // 创建一个临时二项队列，只包含新插入的元素（作为一棵 B0 树）。
-        BinomialQueue<Comparable> singleNodeQueue;
-        singleNodeQueue.theTrees.resize(1, nullptr);    // B0 树位于索引 0
-        singleNodeQueue.theTrees[0] = new BinomialNode(x);
-        singleNodeQueue.currentSize = 1;
-
-        // 将这个包含单个元素的队列与当前队列合并。
-        merge(singleNodeQueue);
+        BinomialNode *carry = pool->allocate(x);
+        ++currentSize;
+        int newCapacity = calculateMinRequiredCapacity();
+        if (theTrees.size() < static_cast<size_t>(newCapacity)) {
+            theTrees.resize(newCapacity, nullptr);
+        }
+
+        int i = 0;
+        while (theTrees[i] != nullptr) {
+            carry = combineTrees(theTrees[i], carry);
+            theTrees[i] = nullptr;
+            ++i;
+        }
+        theTrees[i] = carry;
     }
 
     // 从二项队列中删除最小元素。
@@ -223,12 +382,11 @@ public:
         // 之所以把一家老小全都删了，是因为子树们要自己搞一个新的二项队列，所以直接跟原来的saygoodbye了
         currentSize -= (1 << minTreeIdx);
 
-        // 4. 创建一个临时二项队列，用于存放被删除根节点的所有子树。
-        BinomialQueue<Comparable> tempQueueForChildren;
-        // 调整临时队列的 theTrees 向量大小，使其能够容纳所有可能阶数的子树。
+        // 4. 用 childTrees 充当一个临时二项队列，存放被删除根节点的所有子树。
+        // 调整它的大小，使其能够容纳所有可能阶数的子树。
         // 一棵 B_k 树的子树阶数从 B_{k-1} 到 B_0，共 k 棵树。因此需要 k 个槽位（索引 0 到 k-1）。
-        tempQueueForChildren.theTrees.resize(minTreeIdx);    // 如果 minTreeIdx 是 0 (B0树), 则 resize(0)
-        tempQueueForChildren.currentSize = 0;                // 临时队列的元素数量将在后续填充时更新
+        childTrees.assign(minTreeIdx, nullptr);    // 如果 minTreeIdx 是 0 (B0树), 则为空
+        int childrenSize = 0;                      // 临时队列的元素数量将在后续填充时更新
 
         // 5. 遍历被删除根节点的所有子树（它们通过 nextSibling 连接），
         // 并将它们作为独立的二项树放入临时队列中。
@@ -244,24 +402,24 @@ public:
             // 对于3阶二项树，其根节点共有3个儿子，树的高度为3+1=4
             // 从上往下，各层节点数目为1331，相加为2^3（恭喜，成功与二项式定义联系起来了）
             // 当根节点消失后，这三个儿子只要彼此断开链接，就能成为独立的012阶二项树（画图验证）
-            tempQueueForChildren.theTrees[i] = childrenHead;
+            childTrees[i] = childrenHead;
             // 移动 childrenHead 到下一个兄弟节点，为下一轮循环做准备。
             BinomialNode *nextChild = childrenHead->nextSibling;
             // 断开当前子树与下一个兄弟子树之间的链接，使其成为临时队列中的一棵独立二项树的根。
-            tempQueueForChildren.theTrees[i]->nextSibling = nullptr;
+            childTrees[i]->nextSibling = nullptr;
             childrenHead = nextChild;    // 更新 childrenHead
 
             // 更新临时队列的元素总数：加上当前子树的节点数量 (2^i)。
             // 7 = 2^3 - 1 = 2^2 + 2^1 + 2^0
-            tempQueueForChildren.currentSize += (1 << i);
+            childrenSize += (1 << i);
         }
 
-        // 6. 删除原队列中的根节点本身（释放其内存）。
-        delete oldRootNode;
+        // 6. 删除原队列中的根节点本身（把它还给节点池）。
+        pool->deallocate(oldRootNode);
 
         // 7. 将包含所有子树的临时队列与原队列合并。
         // 这样，被删除根节点的子树就被重新整合到队列中，并维护了二项队列的性质。
-        merge(tempQueueForChildren);
+        mergeTrees(childTrees, childrenSize);
     }
 
     // deleteMin 的重载版本：删除最小元素并将其值通过引用参数返回。
@@ -282,37 +440,75 @@ public:
 
     // 清空整个二项队列，释放所有节点内存。
     void makeEmpty() {
-        // 遍历 theTrees 向量中的每一棵二项树，并调用辅助函数 makeEmpty() 递归清空它们。
+        if (currentSize == 0) {
+            return;    // 空队列什么也不做，尤其不能 reset 可能被别人使用的池
+        }
+
+        // 池只有本队列在用时，池里的节点全是本队列的，可以整池 reset，不用逐个归还
+        // 元素是平凡析构的（如 int）时连遍历都省了；否则仍要遍历一遍，调用元素的析构函数
+        bool exclusivePool = pool.use_count() == 1;
+        bool skipTraversal = exclusivePool && std::is_trivially_destructible<Comparable>::value;
+        // 遍历 theTrees 向量中的每一棵二项树，并调用辅助函数 makeEmpty() 清空它们。
         // 有参的 makeEmpty() 是用来清空所有二叉树的，二项队列是二叉树的集合
         for (int i = 0; i < theTrees.size(); ++i) {
-            makeEmpty(theTrees[i]);    // theTrees[i] 传入的是指针的引用
+            if (skipTraversal) {
+                theTrees[i] = nullptr;
+            } else {
+                makeEmpty(theTrees[i], exclusivePool);    // theTrees[i] 传入的是指针的引用
+            }
+        }
+        if (exclusivePool) {
+            pool->reset();
         }
         currentSize = 0;               // 重置队列的总元素数量
     }
 
     // 将当前二项队列与另一个二项队列 (rhs) 合并。
     // 合并后，rhs 队列将变为空。
+    // 两者共用节点池时只挂指针；否则 rhs 的节点属于别的池，要先复制到本队列的池中
     void merge(BinomialQueue &rhs) {
         // 防止自合并：如果尝试将队列与自身合并，直接返回，不做任何操作。
         if (this == &rhs) {
             return;
         }
 
+        if (rhs.pool != pool) {
+            std::vector<BinomialNode *> copiedTrees(rhs.theTrees.size(), nullptr);
+            for (size_t i = 0; i < rhs.theTrees.size(); ++i) {
+                copiedTrees[i] = clone(rhs.theTrees[i]);
+            }
+            int rhsSize = rhs.currentSize;
+            rhs.makeEmpty();
+            mergeTrees(copiedTrees, rhsSize);
+            return;
+        }
+
+        mergeTrees(rhs.theTrees, rhs.currentSize);
+        rhs.currentSize = 0;              // 重置 rhs 队列的元素数量
+    }
+
+private:
+    // 把另一组二项树（rhsTrees[i] 是 i 阶树或 nullptr，共 rhsSize 个元素）合并到当前队列
+    // 节点必须来自本队列的池。合并后 rhsTrees 全部置空
+    void mergeTrees(std::vector<BinomialNode *> &rhsTrees, int rhsSize) {
         // 核心合并逻辑，类似于二进制加法：
         // 抓住二进制加法的逻辑就很简单了，从低位到高位逐位相加
         // `carry` 指针用于暂存合并过程中产生的进位树（当同一阶数有两棵树合并成一棵更高阶数的树时）。
         BinomialNode *carry = nullptr;
 
         // 更新当前队列的总元素数量。
-        currentSize += rhs.currentSize;
+        currentSize += rhsSize;
 
         // 调整当前队列的 theTrees 向量大小，使其能够容纳合并后的所有可能阶数的树。
-        // 新的容量是两个队列中最大阶数 + 1（因为可能出现进位到新的最高阶数）。
+        // 合并后的元素个数写成二进制有几位，就需要几个槽位，进位不会超出这个范围。
         // 这个道理学高精度加法的时候就知道了，不多赘述。加法的极限就是进一位
-        // 使用 calculateMinRequiredCapacity(currentSize) 也可以，但这里直接用 max 即可。
-        int newCapacity = std::max(theTrees.size(), rhs.theTrees.size()) + 1;
-        // resize 会填充新元素为默认值 (nullptr)，旧元素保持不变。
-        theTrees.resize(newCapacity, nullptr);
+        // 注意只能在不够时扩容：如果每次都扩成 max(两者大小) + 1，insert n 次后 theTrees 就有 n 个槽位，
+        // findMinTreeIndex 要扫描全部槽位，deleteMin 和 findMin 会退化成 O(n)
+        int newCapacity = calculateMinRequiredCapacity();
+        if (theTrees.size() < static_cast<size_t>(newCapacity)) {
+            // resize 会填充新元素为默认值 (nullptr)，旧元素保持不变。
+            theTrees.resize(newCapacity, nullptr);
+        }
 
         // 遍历所有可能的树阶数，从阶数 0 开始。
         // 循环终止条件通常是遍历完所有可能存在的最高阶数，或者当 currentSize 不再需要更高的阶数时。
@@ -326,7 +522,7 @@ public:
             // carry: 来自上一阶数合并的进位
             BinomialNode *t1 = theTrees[i];
             // 待合并二项队列没扩容，有可能越界访问
-            BinomialNode *t2 = (i < rhs.theTrees.size()) ? rhs.theTrees[i] : nullptr;
+            BinomialNode *t2 = (i < rhsTrees.size()) ? rhsTrees[i] : nullptr;
 
             // 根据 t1, t2, carry 的存在与否，判断是哪种合并情况（共 8 种）。
             // 8种由来：高中概率，2^3 = 8
@@ -349,7 +545,7 @@ public:
             // 情况 2: 只有 t2 存在。结果：t2，进位：0。
             case 2:
                 theTrees[i] = t2;             // 将 t2 移动到当前队列的位置
-                rhs.theTrees[i] = nullptr;    // 清空 rhs 队列的对应位置
+                rhsTrees[i] = nullptr;    // 清空 rhs 队列的对应位置
                 break;
 
             // 情况 4: 只有 carry 存在。结果：carry，进位：0。
@@ -363,7 +559,7 @@ public:
             case 3:
                 carry = combineTrees(t1, t2);    // 合并 t1 和 t2，结果成为进位
                 theTrees[i] = nullptr;           // 当前位置清空
-                rhs.theTrees[i] = nullptr;       // rhs 对应位置清空
+                rhsTrees[i] = nullptr;       // rhs 对应位置清空
                 break;
 
             // 情况 5: t1 和 carry 存在。结果：0，进位：t1 和 carry 合并后的树。
@@ -377,7 +573,7 @@ public:
             // 0 + 1 + 1 = 10
             case 6:
                 carry = combineTrees(t2, carry);    // 合并 t2 和 carry，结果成为进位
-                rhs.theTrees[i] = nullptr;          // rhs 对应位置清空
+                rhsTrees[i] = nullptr;          // rhs 对应位置清空
                 break;
 
             // 情况 7: t1, t2 和 carry 都存在。结果：carry（当前位置放置 carry），进位：t1 和 t2 合并后的树。
@@ -385,18 +581,19 @@ public:
             case 7:
                 theTrees[i] = carry;             // 将 carry 放置在当前位置
                 carry = combineTrees(t1, t2);    // 合并 t1 和 t2，结果成为新的进位
-                rhs.theTrees[i] = nullptr;       // rhs 对应位置清空
+                rhsTrees[i] = nullptr;       // rhs 对应位置清空
                 break;
             }
         }
 
         // 下面这段代码是鲁棒性的体现，可以不要
-        for (int k = 0; k < rhs.theTrees.size(); ++k) {
-            rhs.theTrees[k] = nullptr;    // 将 rhs 队列的树指针置空
+        for (int k = 0; k < rhsTrees.size(); ++k) {
+            rhsTrees[k] = nullptr;    // 将 rhs 队列的树指针置空
         }
-        rhs.currentSize = 0;              // 重置 rhs 队列的元素数量
     }
 
+public:
+
     // 拷贝赋值运算符：实现深拷贝，将 rhs 的内容复制到当前对象。
     const BinomialQueue &operator=(const BinomialQueue &rhs) {
         if (this != &rhs) {    // 检查自赋值，防止自我拷贝导致内存问题
@@ -408,7 +605,7 @@ public:
             // 调整 theTrees 向量的大小，并进行深拷贝
             theTrees.resize(rhs.theTrees.size());    // 调整大小以匹配源队列
             for (int i = 0; i < theTrees.size(); ++i) {
-                // 递归克隆每一棵二项树
+                // 克隆每一棵二项树到本队列的节点池
                 // clone函数是用来深拷贝二项树的
                 // 如果这个位置没有二项树，clone函数会返回nullptr的
                 theTrees[i] = clone(rhs.theTrees[i]);
@@ -418,6 +615,58 @@ public:
     }
 };
 
+// 其他文件会直接 #include 本文件来复用 BinomialQueue
+// 它们在 #include 之前定义 BINOMIAL_QUEUE_NO_MAIN，跳过下面的 main
+#ifndef BINOMIAL_QUEUE_NO_MAIN
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 节点池的效果：插入、删除、清空的耗时，以及共用池和不共用池时 merge 的差别
+void benchmarkNodePool(int n) {
+    std::cout << "\nNode pool, " << n << " elements:" << std::endl;
+    BinomialQueue<int> bq;
+    unsigned seed = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        bq.insert(seed >> 8);
+    }
+    std::cout << "  insert:      " << elapsedMs(start) << " ms, pool memory "
+              << bq.nodePool()->memoryUsage() / 1024 << " KB" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n / 10; ++i) {
+        bq.deleteMin();
+    }
+    std::cout << "  deleteMin:   " << elapsedMs(start) << " ms for " << n / 10 << " calls" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    bq.makeEmpty();    // 独占的池，整池 reset
+    std::cout << "  makeEmpty:   " << elapsedMs(start) << " ms, live nodes " << bq.nodePool()->liveCount() << std::endl;
+
+    // 共用池：merge 只挂指针
+    BinomialQueue<int> left;
+    BinomialQueue<int> right(left.nodePool());
+    for (int i = 0; i < n; ++i) {
+        (i % 2 == 0 ? left : right).insert(i);
+    }
+    start = std::chrono::steady_clock::now();
+    left.merge(right);
+    std::cout << "  merge (shared pool):   " << elapsedMs(start) << " ms, min " << left.findMin() << ", size "
+              << left.size() << std::endl;
+
+    // 不共用池：rhs 的节点要复制过来
+    BinomialQueue<int> other;
+    for (int i = 0; i < n / 2; ++i) {
+        other.insert(n + i);
+    }
+    start = std::chrono::steady_clock::now();
+    left.merge(other);
+    std::cout << "  merge (separate pool): " << elapsedMs(start) << " ms, size " << left.size() << std::endl;
+}
+
 // --- 主函数 (示例用法) ---
 int main() {
     BinomialQueue<int> bq1;
@@ -477,5 +726,9 @@ int main() {
         std::cout << "Deleted " << val << ", new min: " << (bq1.isEmpty() ? "N/A" : std::to_string(bq1.findMin())) << std::endl;
     }
 
+    benchmarkNodePool(1000000);
+
     return 0;
 }
+
+#endif    // BINOMIAL_QUEUE_NO_MAIN
@@ -0,0 +1,129 @@
+// 桶队列（Bucket Queue，Dial 算法用的优先队列）
+// 和基数堆一样要求单调：之后插入的键值不小于最近取出的最小键值 cursor
+// 再加一个条件：所有键值都在 [cursor, cursor + maxSpan] 之内
+// Dijkstra 中，边权都不超过 C 时，堆里的距离一定在 [当前出堆的距离, 当前出堆的距离 + C] 之内，maxSpan 取 C 即可
+
+// 结构：maxSpan + 1 个桶组成一个环，键值 key 放进第 key % (maxSpan + 1) 个桶
+// 任意时刻有效的键值范围正好是 maxSpan + 1 个，所以每个桶里的键值都相同，不需要存键值
+// 1. insert：O(1)
+// 2. extractMin：从 cursor 开始往后找第一个非空的桶，cursor 总共只前进“最大键值 - 最小键值”步
+//    Dijkstra 总共是 O(E + V + 最短路的最大距离)，边权很小时比任何基于比较的堆都快
+// 代价是内存和 maxSpan 成正比，边权范围很大时应该用基数堆
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template<class Value>
+class BucketQueue {
+private:
+    std::vector<std::vector<Value>> buckets;
+    long long cursor;    // 最近一次取出的最小键值，也是扫描的起点
+    int currentSize;
+
+    std::vector<Value> &bucketOf(long long key) {
+        return buckets[key % static_cast<long long>(buckets.size())];
+    }
+
+    // 把 cursor 移到第一个非空的桶，调用前队列不能为空
+    void advance() {
+        while (bucketOf(cursor).empty()) {
+            ++cursor;
+        }
+    }
+
+public:
+    // maxSpan 是队列中键值与 cursor 之差的上界，不能为负数
+    explicit BucketQueue(int maxSpan) : cursor(0), currentSize(0) {
+        if (maxSpan < 0) {
+            throw std::invalid_argument("BucketQueue: maxSpan must be non-negative.");
+        }
+        buckets.resize(static_cast<size_t>(maxSpan) + 1);
+    }
+
+    bool isEmpty() const {
+        return currentSize == 0;
+    }
+
+    int size() const {
+        return currentSize;
+    }
+
+    int maxSpan() const {
+        return buckets.size() - 1;
+    }
+
+    // 键值必须在 [cursor, cursor + maxSpan] 之内，否则抛出 std::invalid_argument
+    void insert(long long key, const Value &value) {
+        if (key < cursor || key - cursor > maxSpan()) {
+            throw std::invalid_argument("BucketQueue: key is outside [cursor, cursor + maxSpan].");
+        }
+        bucketOf(key).push_back(value);
+        ++currentSize;
+    }
+
+    long long minKey() {
+        if (isEmpty()) {
+            throw std::runtime_error("BucketQueue is empty. Cannot get min key.");
+        }
+        advance();
+        return cursor;
+    }
+
+    // 删除并返回一个键值最小的 (key, value)
+    std::pair<long long, Value> extractMin() {
+        if (isEmpty()) {
+            throw std::runtime_error("BucketQueue is empty. Cannot extract min.");
+        }
+        advance();
+        std::vector<Value> &bucket = bucketOf(cursor);
+        std::pair<long long, Value> result(cursor, std::move(bucket.back()));
+        bucket.pop_back();
+        --currentSize;
+        return result;
+    }
+
+    // 清空，cursor 回到 0
+    void clear() {
+        for (auto &bucket : buckets) {
+            bucket.clear();
+        }
+        cursor = 0;
+        currentSize = 0;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 BucketQueue
+// 它们在 #include 之前定义 BUCKET_QUEUE_NO_MAIN，跳过下面的 main
+#ifndef BUCKET_QUEUE_NO_MAIN
+
+int main() {
+    BucketQueue<char> queue(10);    // 键值和 cursor 之差不超过 10
+    std::cout << "Inserting (5,a), (3,b), (9,c), (3,d)..." << std::endl;
+    queue.insert(5, 'a');
+    queue.insert(3, 'b');
+    queue.insert(9, 'c');
+    queue.insert(3, 'd');
+    std::cout << "Min key: " << queue.minKey() << std::endl;    // 3
+
+    // cursor 移到了 3，有效范围变成 [3, 13]
+    std::cout << "Inserting (12,e)..." << std::endl;
+    queue.insert(12, 'e');
+    try {
+        queue.insert(20, 'f');
+    } catch (const std::invalid_argument &e) {
+        std::cout << "Inserting (20,f) failed: " << e.what() << std::endl;
+    }
+
+    std::cout << "Extract order (key:value): ";
+    while (!queue.isEmpty()) {
+        auto item = queue.extractMin();
+        std::cout << item.first << ":" << item.second << " ";
+    }
+    std::cout << std::endl;    // 3 3 5 9 12
+
+    return 0;
+}
+
+#endif    // BUCKET_QUEUE_NO_MAIN
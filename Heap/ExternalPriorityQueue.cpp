@@ -0,0 +1,394 @@
+// 外存优先队列（External-Memory Priority Queue）
+// 元素多到内存放不下时，把一部分数据放到磁盘上，内存只用一个固定的预算 memoryBytes
+// 1. 插入缓冲区：一个 MinHeap，占预算的一半。insert 只往这里插，满了就整个倒出来（依次 extractMin，得到有序序列），
+//    写成磁盘上的一个有序段（run），缓冲区清空
+// 2. 每个 run 在内存里只保留一个块（block）作为读缓冲，块用完了再从文件顺序读下一块
+//    所有 run 的当前头部放在另一个小 MinHeap（heads）里
+// 3. extractMin：比较插入缓冲区的堆顶和 heads 的堆顶，取较小的。取自某个 run 时，用它的下一个元素 replaceTop
+//    run 是惰性归并的：不会事先把所有 run 合成一个，而是取到哪里读到哪里
+// 4. run 的个数受读缓冲的内存限制：预算的另一半除以块大小。run 太多时，用败者树（LoserTree.cpp）把它们一次归并成一个
+// 所有磁盘读写都是整块的顺序 I/O，块默认 1 MiB，文件关掉了 stdio 自带的缓冲，避免多拷贝一次
+// 设 run 的上限为 F（= 预算的一半 / 块大小），缓冲区大小为 M/2：数据量不超过 F * M/2 时不会发生归并，
+// 每个元素只写一次、读一次，吞吐量和纯内存的堆只差一个不大的常数倍（例如预算 1 GiB、块 1 MiB 时 F = 511，约 255 GiB）
+// 超出之后每攒满 F 个 run 就要把已有的数据整体重写一遍，预算太小时 I/O 量会明显增加，main 中 8 MiB 的测试就是这种情况
+
+// 插入缓冲区在构造时一次分配好一半预算的空间，不会因为 vector 按倍数扩容而超出预算
+// 元素类型必须是 trivially copyable 的，按字节原样写入文件
+// 临时文件由 std::tmpfile 创建，关闭（或程序退出）时自动删除
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define LOSER_TREE_NO_MAIN
+#include "LoserTree.cpp"    // 其中已经包含了 BinaryHeap.cpp
+
+template<class T, class Compare = std::less<T>>
+class ExternalPriorityQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "ExternalPriorityQueue: T must be trivially copyable.");
+
+private:
+    // 临时文件的所有者，离开作用域（包括写文件、归并中途抛出异常）时自动关闭，文件随之删除
+    struct FileCloser {
+        void operator()(FILE *file) const {
+            std::fclose(file);
+        }
+    };
+    typedef std::unique_ptr<FILE, FileCloser> TempFile;
+
+    // 磁盘上的一个有序段，内存中只有当前的一个块
+    class Run {
+    private:
+        TempFile file;
+        long long remaining;    // 文件中还没有读进来的元素个数
+        std::vector<T> block;
+        size_t position;        // 当前头部在 block 中的下标
+        size_t blockElements;
+        long long &bytesRead;
+
+        void refill() {
+            size_t n = std::min<long long>(blockElements, remaining);
+            block.resize(n);
+            if (std::fread(block.data(), sizeof(T), n, file.get()) != n) {
+                throw std::runtime_error("ExternalPriorityQueue: failed to read a run from the temporary file.");
+            }
+            remaining -= n;
+            position = 0;
+            bytesRead += n * sizeof(T);
+        }
+
+    public:
+        // file 已经写好 count 个有序的元素，并且读写位置在开头
+        Run(TempFile file, long long count, size_t blockElements, long long &bytesRead)
+            : file(std::move(file)), remaining(count), position(0), blockElements(blockElements), bytesRead(bytesRead) {
+            refill();
+        }
+
+        Run(const Run &) = delete;
+        Run &operator=(const Run &) = delete;
+
+        bool isEmpty() const {
+            return position == block.size() && remaining == 0;
+        }
+
+        const T &front() const {
+            return block[position];
+        }
+
+        void advance() {
+            if (++position == block.size() && remaining > 0) {
+                refill();
+            }
+        }
+    };
+
+    // 把 Run 包装成 input iterator，交给 KWayMerge 归并。只支持和“末尾”比较
+    class RunIterator {
+    private:
+        Run *run;    // nullptr 表示末尾
+
+        bool atEnd() const {
+            return run == nullptr || run->isEmpty();
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        explicit RunIterator(Run *run = nullptr) : run(run) {}
+
+        const T &operator*() const {
+            return run->front();
+        }
+
+        RunIterator &operator++() {
+            run->advance();
+            return *this;
+        }
+
+        bool operator==(const RunIterator &other) const {
+            return atEnd() == other.atEnd();
+        }
+
+        bool operator!=(const RunIterator &other) const {
+            return !(*this == other);
+        }
+    };
+
+    // heads 中的元素是 (run 的当前头部, run)，只按头部比较
+    struct HeadCompare {
+        Compare comp;
+        bool operator()(const std::pair<T, Run *> &a, const std::pair<T, Run *> &b) const {
+            return comp(a.first, b.first);
+        }
+    };
+
+    Compare comp;
+    size_t blockElements;
+    size_t bufferCapacity;    // 插入缓冲区最多放多少个元素
+    size_t maxRuns;           // 同时存在的 run 最多有多少个
+    MinHeap<T, Compare> buffer;
+    MinHeap<std::pair<T, Run *>, HeadCompare> heads;
+    std::vector<std::unique_ptr<Run>> runs;
+    std::vector<T> writeBlock;    // 写文件用的块，spill 和归并共用
+    long long count;
+
+    int spills;
+    int compactions;
+    long long bytesWritten;
+    long long bytesRead;
+
+    TempFile createTempFile() {
+        TempFile file(std::tmpfile());
+        if (!file) {
+            throw std::runtime_error("ExternalPriorityQueue: cannot create a temporary file.");
+        }
+        std::setvbuf(file.get(), nullptr, _IONBF, 0);    // 每次都是整块读写，不需要 stdio 再缓冲一次
+        return file;
+    }
+
+    void append(FILE *file, const T &value) {
+        writeBlock.push_back(value);
+        if (writeBlock.size() == blockElements) {
+            flush(file);
+        }
+    }
+
+    void flush(FILE *file) {
+        if (std::fwrite(writeBlock.data(), sizeof(T), writeBlock.size(), file) != writeBlock.size()) {
+            throw std::runtime_error("ExternalPriorityQueue: failed to write a run to the temporary file.");
+        }
+        bytesWritten += writeBlock.size() * sizeof(T);
+        writeBlock.clear();
+    }
+
+    // 写完的文件变成一个新的 run
+    void addRun(TempFile file, long long size) {
+        flush(file.get());
+        std::rewind(file.get());
+        runs.push_back(std::unique_ptr<Run>(new Run(std::move(file), size, blockElements, bytesRead)));
+        heads.insert({runs.back()->front(), runs.back().get()});
+    }
+
+    void removeRun(Run *run) {
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (runs[i].get() == run) {
+                runs.erase(runs.begin() + i);
+                return;
+            }
+        }
+    }
+
+    // 把所有 run 剩下的部分用败者树归并成一个 run，heads 重建
+    void compact() {
+        std::vector<std::pair<RunIterator, RunIterator>> ranges;
+        long long total = 0;
+        for (const auto &run : runs) {
+            ranges.push_back({RunIterator(run.get()), RunIterator()});
+        }
+        TempFile file = createTempFile();
+        KWayMerge<RunIterator, Compare> merger(ranges, comp);
+        while (!merger.isEmpty()) {
+            append(file.get(), merger.next());
+            ++total;
+        }
+        runs.clear();
+        heads = MinHeap<std::pair<T, Run *>, HeadCompare>(HeadCompare{comp});
+        addRun(std::move(file), total);
+        ++compactions;
+    }
+
+    // 插入缓冲区满了，按顺序倒出来写成一个新的 run
+    void spill() {
+        if (runs.size() >= maxRuns) {
+            compact();
+        }
+        TempFile file = createTempFile();
+        long long size = buffer.size();
+        while (!buffer.isEmpty()) {
+            append(file.get(), buffer.extractMin());
+        }
+        addRun(std::move(file), size);
+        ++spills;
+    }
+
+    // 下一个要取出的元素是否在插入缓冲区里
+    bool minInBuffer() const {
+        return heads.isEmpty() || (!buffer.isEmpty() && !comp(heads.peek().first, buffer.peek()));
+    }
+
+public:
+    // memoryBytes：内存预算，一半给插入缓冲区，另一半给各个 run 的读缓冲和一个写缓冲
+    // blockBytes：每次读写磁盘的块大小。预算至少要放下 6 个块（至少能同时有 2 个 run），否则抛出 std::invalid_argument
+    explicit ExternalPriorityQueue(size_t memoryBytes, size_t blockBytes = 1 << 20, const Compare &compare = Compare())
+        : comp(compare), blockElements(blockBytes / sizeof(T)), bufferCapacity(memoryBytes / 2 / sizeof(T)),
+          maxRuns(memoryBytes / 2 / std::max(blockBytes, sizeof(T)) - 1), buffer(compare), heads(HeadCompare{compare}),
+          count(0), spills(0), compactions(0), bytesWritten(0), bytesRead(0) {
+        if (blockElements == 0 || memoryBytes < 6 * blockBytes) {
+            throw std::invalid_argument("ExternalPriorityQueue: memory budget must hold at least 6 blocks.");
+        }
+        buffer.reserve(bufferCapacity);
+        writeBlock.reserve(blockElements);
+    }
+
+    ExternalPriorityQueue(const ExternalPriorityQueue &) = delete;
+    ExternalPriorityQueue &operator=(const ExternalPriorityQueue &) = delete;
+
+    void insert(const T &value) {
+        if (static_cast<size_t>(buffer.size()) == bufferCapacity) {
+            spill();
+        }
+        buffer.insert(value);
+        ++count;
+    }
+
+    // 返回最小的元素，为空时抛出 std::runtime_error
+    const T &peek() const {
+        if (isEmpty()) {
+            throw std::runtime_error("ExternalPriorityQueue is empty. Cannot peek.");
+        }
+        return minInBuffer() ? buffer.peek() : heads.peek().first;
+    }
+
+    // 删除并返回最小的元素，为空时抛出 std::runtime_error
+    T extractMin() {
+        if (isEmpty()) {
+            throw std::runtime_error("ExternalPriorityQueue is empty. Cannot extract min.");
+        }
+        --count;
+        if (minInBuffer()) {
+            return buffer.extractMin();
+        }
+        T result = heads.peek().first;
+        Run *run = heads.peek().second;
+        run->advance();
+        if (run->isEmpty()) {
+            heads.extractMin();
+            removeRun(run);
+        } else {
+            heads.replaceTop({run->front(), run});
+        }
+        return result;
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    long long size() const {
+        return count;
+    }
+
+    // 当前磁盘上的 run 个数
+    int runCount() const {
+        return runs.size();
+    }
+
+    int spillCount() const {
+        return spills;
+    }
+
+    int compactionCount() const {
+        return compactions;
+    }
+
+    long long totalBytesWritten() const {
+        return bytesWritten;
+    }
+
+    long long totalBytesRead() const {
+        return bytesRead;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 ExternalPriorityQueue
+// 它们在 #include 之前定义 EXTERNAL_PRIORITY_QUEUE_NO_MAIN，跳过下面的测试代码和 main
+#ifndef EXTERNAL_PRIORITY_QUEUE_NO_MAIN
+
+// 先插入 n 个随机数再全部取出，和纯内存的 MinHeap 比较耗时，并检查取出的顺序相同
+void benchmarkExternal(int n, size_t memoryBytes) {
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::vector<int> values(n);
+    unsigned seed = 2024;
+    for (int &v : values) {
+        seed = seed * 1664525u + 1013904223u;
+        v = static_cast<int>(seed >> 2);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MinHeap<int> heap;
+    for (int v : values) {
+        heap.insert(v);
+    }
+    std::vector<int> inMemory;
+    inMemory.reserve(n);
+    while (!heap.isEmpty()) {
+        inMemory.push_back(heap.extractMin());
+    }
+    auto heapDone = std::chrono::steady_clock::now();
+
+    ExternalPriorityQueue<int> external(memoryBytes);
+    for (int v : values) {
+        external.insert(v);
+    }
+    auto insertDone = std::chrono::steady_clock::now();
+    std::vector<int> fromDisk;
+    fromDisk.reserve(n);
+    while (!external.isEmpty()) {
+        fromDisk.push_back(external.extractMin());
+    }
+    auto externalDone = std::chrono::steady_clock::now();
+
+    std::cout << "  " << n << " ints (" << n * sizeof(int) / (1 << 20) << " MiB), budget "
+              << memoryBytes / (1 << 20) << " MiB:" << std::endl;
+    std::cout << "    in-memory MinHeap: " << ms(start, heapDone) << " ms" << std::endl;
+    std::cout << "    external: " << ms(heapDone, externalDone) << " ms (insert " << ms(heapDone, insertDone)
+              << " ms), " << external.spillCount() << " spills, " << external.compactionCount() << " compactions, "
+              << external.totalBytesWritten() / (1 << 20) << " MiB written, " << external.totalBytesRead() / (1 << 20)
+              << " MiB read, " << (fromDisk == inMemory ? "same result" : "RESULTS DIFFER") << std::endl;
+}
+
+int main() {
+    // 很小的预算：每块 4 个 int，预算 32 个 int，插入缓冲区放 16 个，最多 3 个 run
+    ExternalPriorityQueue<int> queue(32 * sizeof(int), 4 * sizeof(int));
+    for (int i = 0; i < 100; ++i) {
+        queue.insert(i * 37 % 101);
+    }
+    std::cout << "Size: " << queue.size() << ", runs on disk: " << queue.runCount()
+              << ", spills: " << queue.spillCount() << ", compactions: " << queue.compactionCount() << std::endl;
+    std::cout << "First 10 extracted: ";
+    for (int i = 0; i < 10; ++i) {
+        std::cout << queue.extractMin() << " ";
+    }
+    std::cout << std::endl;    // 0 1 2 3 4 5 6 7 8 9
+    queue.insert(3);
+    std::cout << "After inserting 3 again, min: " << queue.peek() << std::endl;    // 3
+
+    try {
+        ExternalPriorityQueue<int> tooSmall(1 << 20, 1 << 20);
+    } catch (const std::invalid_argument &e) {
+        std::cout << "Constructing with 1 MiB budget and 1 MiB blocks failed: " << e.what() << std::endl;
+    }
+
+    std::cout << "\n--- Insert n, then extract n ---" << std::endl;
+    for (size_t budget : {8 << 20, 16 << 20}) {
+        benchmarkExternal(1 << 24, budget);
+    }
+
+    return 0;
+}
+
+#endif    // EXTERNAL_PRIORITY_QUEUE_NO_MAIN
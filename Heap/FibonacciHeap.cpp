@@ -0,0 +1,332 @@
+// 斐波那契堆（Fibonacci Heap）
+// 和二项队列一样是一组最小堆有序的树，区别在于它把整理工作推迟到 deleteMin 时才做：
+// 1. 所有树的根串成一个双向循环链表（根表），min 指向最小的根
+// 2. insert：新节点直接放进根表，O(1)。二项队列要做一次 merge，O(log n)
+// 3. merge：把两个根表首尾接起来，O(1)
+// 4. deleteMin：删掉最小的根，它的孩子全部放进根表，然后“合并”（consolidate）：
+//    按度数（孩子个数）分桶，度数相同的两棵树 link 成度数加一的树，直到所有根的度数都不同
+//    这和二项队列 merge 时的进位是同一个思路，均摊 O(log n)
+// 5. decreaseKey：如果新值比父节点小，就把节点连同子树剪下来放进根表，O(1) 均摊
+//    为了不让树被剪得太稀疏，每个节点有一个 mark：非根节点第一次失去孩子时做标记，第二次失去孩子时自己也被剪下（级联剪切）
+//    这样度数为 k 的树至少有 F(k+2) 个节点（斐波那契数），度数上界是 log_phi(n)，名字就是这么来的
+
+// 每个节点的孩子也是双向循环链表，父节点只记录其中一个孩子
+// 句柄（Handle）：insert 返回指向节点的句柄，decreaseKey 通过句柄直接找到节点
+// 句柄在对应元素被 deleteMin 删除、或 makeEmpty 之后失效
+
+#include <iostream>
+#include <stdexcept>    // For std::underflow_error
+#include <utility>      // For std::swap
+#include <vector>
+
+template<class Comparable>
+class FibonacciHeap {
+private:
+    struct FibNode {
+        Comparable element;
+        FibNode *parent;
+        FibNode *child;    // 孩子链表中的任意一个
+        FibNode *left;     // 所在循环链表的左右邻居
+        FibNode *right;
+        int degree;        // 孩子个数
+        bool mark;         // 成为别人的孩子之后，是否已经失去过一个孩子
+
+        FibNode(const Comparable &theElement)
+            : element(theElement), parent(nullptr), child(nullptr), left(this), right(this), degree(0), mark(false) {}
+    };
+
+    FibNode *minNode;    // 根表中最小的根，也是根表的入口；堆为空时为 nullptr
+    int currentSize;
+    std::vector<FibNode *> degreeTable;    // consolidate 时按度数分桶，作为成员复用
+    std::vector<FibNode *> rootBuffer;     // consolidate 时暂存根表
+
+    // 把 x 从它所在的循环链表中摘下，x 自成一个链表
+    static void removeFromList(FibNode *x) {
+        x->left->right = x->right;
+        x->right->left = x->left;
+        x->left = x;
+        x->right = x;
+    }
+
+    // 把循环链表 b 整个接到循环链表 a 的 a 节点后面
+    static void spliceLists(FibNode *a, FibNode *b) {
+        FibNode *aRight = a->right;
+        FibNode *bLeft = b->left;
+        a->right = b;
+        b->left = a;
+        bLeft->right = aRight;
+        aRight->left = bLeft;
+    }
+
+    // 把单个节点 x 放进根表，并更新 minNode
+    void addToRootList(FibNode *x) {
+        x->parent = nullptr;
+        x->mark = false;
+        if (minNode == nullptr) {
+            x->left = x;
+            x->right = x;
+            minNode = x;
+        } else {
+            spliceLists(minNode, x);
+            if (x->element < minNode->element) {
+                minNode = x;
+            }
+        }
+    }
+
+    // 把根 y 挂到根 x 下面，要求 y 已经不在根表里
+    void link(FibNode *y, FibNode *x) {
+        y->parent = x;
+        y->mark = false;
+        if (x->child == nullptr) {
+            x->child = y;
+        } else {
+            spliceLists(x->child, y);
+        }
+        x->degree++;
+    }
+
+    // 合并根表，直到所有根的度数都不同
+    void consolidate() {
+        // link 会改动根表，先把根都取出来
+        rootBuffer.clear();
+        FibNode *w = minNode;
+        do {
+            rootBuffer.push_back(w);
+            w = w->right;
+        } while (w != minNode);
+
+        degreeTable.assign(degreeTable.size(), nullptr);
+        for (FibNode *x : rootBuffer) {
+            int d = x->degree;
+            // 和二进制加法的进位一样：这个度数已经有树了，就 link 成度数加一的树，继续往上进位
+            while (d < static_cast<int>(degreeTable.size()) && degreeTable[d] != nullptr) {
+                FibNode *y = degreeTable[d];
+                if (y->element < x->element) {
+                    std::swap(x, y);
+                }
+                removeFromList(y);
+                link(y, x);
+                degreeTable[d] = nullptr;
+                ++d;
+            }
+            if (d >= static_cast<int>(degreeTable.size())) {
+                degreeTable.resize(d + 1, nullptr);
+            }
+            degreeTable[d] = x;
+        }
+
+        // 留在根表里的正好是 degreeTable 中的树，从中找新的最小根
+        minNode = nullptr;
+        for (FibNode *x : degreeTable) {
+            if (x != nullptr && (minNode == nullptr || x->element < minNode->element)) {
+                minNode = x;
+            }
+        }
+    }
+
+    // 把 x 从父节点 y 的孩子链表中剪下，放进根表
+    void cut(FibNode *x, FibNode *y) {
+        if (x->right == x) {
+            y->child = nullptr;
+        } else {
+            if (y->child == x) {
+                y->child = x->right;
+            }
+            removeFromList(x);
+        }
+        y->degree--;
+        addToRootList(x);
+    }
+
+    // 级联剪切：y 刚失去一个孩子。第一次失去时做标记；已经有标记，说明是第二次，把 y 也剪下，继续检查它的父节点
+    void cascadingCut(FibNode *y) {
+        for (FibNode *z = y->parent; z != nullptr; z = y->parent) {
+            if (!y->mark) {
+                y->mark = true;
+                return;
+            }
+            cut(y, z);
+            y = z;
+        }
+    }
+
+    // 释放所有节点，用显式的栈代替递归
+    void destroy() {
+        if (minNode == nullptr) {
+            return;
+        }
+        std::vector<FibNode *> pending;
+        FibNode *list = minNode;
+        do {
+            pending.push_back(list);
+            list = list->right;
+        } while (list != minNode);
+
+        while (!pending.empty()) {
+            FibNode *x = pending.back();
+            pending.pop_back();
+            if (x->child != nullptr) {
+                FibNode *c = x->child;
+                do {
+                    pending.push_back(c);
+                    c = c->right;
+                } while (c != x->child);
+            }
+            delete x;
+        }
+    }
+
+public:
+    using Handle = FibNode *;    // insert 返回的句柄，用于 decreaseKey
+
+    FibonacciHeap() : minNode(nullptr), currentSize(0) {}
+
+    // 句柄指向的是节点本身，拷贝后的堆和原来的句柄对应不上，所以禁止拷贝
+    FibonacciHeap(const FibonacciHeap &) = delete;
+    FibonacciHeap &operator=(const FibonacciHeap &) = delete;
+
+    ~FibonacciHeap() {
+        makeEmpty();
+    }
+
+    bool isEmpty() const {
+        return minNode == nullptr;
+    }
+
+    int size() const {
+        return currentSize;
+    }
+
+    // 返回最小元素，队列为空时抛出 std::underflow_error
+    const Comparable &findMin() const {
+        if (isEmpty()) {
+            throw std::underflow_error("FibonacciHeap is empty, cannot find minimum.");
+        }
+        return minNode->element;
+    }
+
+    Handle insert(const Comparable &x) {
+        FibNode *newNode = new FibNode(x);
+        addToRootList(newNode);
+        ++currentSize;
+        return newNode;
+    }
+
+    void deleteMin() {
+        if (isEmpty()) {
+            throw std::underflow_error("FibonacciHeap is empty, cannot delete minimum.");
+        }
+        FibNode *z = minNode;
+
+        // 孩子们全部成为根
+        if (z->child != nullptr) {
+            FibNode *c = z->child;
+            do {
+                c->parent = nullptr;
+                c->mark = false;
+                c = c->right;
+            } while (c != z->child);
+            spliceLists(z, z->child);
+        }
+
+        if (z->right == z) {
+            minNode = nullptr;    // z 是唯一的根，也没有孩子
+        } else {
+            minNode = z->right;
+            removeFromList(z);
+            consolidate();
+        }
+        delete z;
+        --currentSize;
+    }
+
+    void deleteMin(Comparable &minItem) {
+        minItem = findMin();
+        deleteMin();
+    }
+
+    // 把句柄 x 对应元素的值减小为 newVal，newVal 比原值大时抛出 std::invalid_argument
+    void decreaseKey(Handle x, const Comparable &newVal) {
+        if (x->element < newVal) {
+            throw std::invalid_argument("FibonacciHeap: decreaseKey cannot increase a key.");
+        }
+        x->element = newVal;
+        FibNode *y = x->parent;
+        if (y != nullptr && x->element < y->element) {
+            cut(x, y);
+            cascadingCut(y);
+        }
+        if (x->element < minNode->element) {
+            minNode = x;
+        }
+    }
+
+    // 将 rhs 合并到当前堆，rhs 变为空，rhs 的句柄继续有效，属于当前堆
+    void merge(FibonacciHeap &rhs) {
+        if (this == &rhs || rhs.minNode == nullptr) {
+            return;
+        }
+        if (minNode == nullptr) {
+            minNode = rhs.minNode;
+        } else {
+            spliceLists(minNode, rhs.minNode);
+            if (rhs.minNode->element < minNode->element) {
+                minNode = rhs.minNode;
+            }
+        }
+        currentSize += rhs.currentSize;
+        rhs.minNode = nullptr;
+        rhs.currentSize = 0;
+    }
+
+    void makeEmpty() {
+        destroy();
+        minNode = nullptr;
+        currentSize = 0;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 FibonacciHeap
+// 它们在 #include 之前定义 FIBONACCI_HEAP_NO_MAIN，跳过下面的 main
+#ifndef FIBONACCI_HEAP_NO_MAIN
+
+int main() {
+    FibonacciHeap<int> heap;
+    std::cout << "Inserting 10, 20, 5, 30, 15, 2, 7..." << std::endl;
+    std::vector<FibonacciHeap<int>::Handle> handles;
+    for (int x : {10, 20, 5, 30, 15, 2, 7}) {
+        handles.push_back(heap.insert(x));
+    }
+    std::cout << "Min element: " << heap.findMin() << std::endl;    // 2
+
+    // 先删一次，触发 consolidate，剩下的 6 个节点被整理成度数不同的树，之后的 decreaseKey 才会真的剪切
+    heap.deleteMin();
+    std::cout << "After deleteMin, min element: " << heap.findMin() << std::endl;    // 5
+
+    std::cout << "\nDecreasing 30 to 1, 20 to 3..." << std::endl;
+    heap.decreaseKey(handles[3], 1);
+    heap.decreaseKey(handles[1], 3);
+    std::cout << "Min element: " << heap.findMin() << std::endl;    // 1
+
+    FibonacciHeap<int> other;
+    std::cout << "\nMerging a heap with 4, 12, 0..." << std::endl;
+    for (int x : {4, 12, 0}) {
+        other.insert(x);
+    }
+    heap.merge(other);
+    std::cout << "Min element: " << heap.findMin() << ", size: " << heap.size()
+              << ", other is empty: " << (other.isEmpty() ? "true" : "false") << std::endl;
+
+    std::cout << "\nDeleting all: ";
+    while (!heap.isEmpty()) {
+        int minItem;
+        heap.deleteMin(minItem);
+        std::cout << minItem << " ";
+    }
+    std::cout << std::endl;    // 0 1 3 4 5 7 10 12 15
+
+    return 0;
+}
+
+#endif    // FIBONACCI_HEAP_NO_MAIN
@@ -0,0 +1,227 @@
+// 败者树（Loser Tree）与 k 路归并
+// k 个有序序列归并成一个，每一步要从 k 个序列的当前头部中选出最小的
+// 用最小堆做：弹出堆顶，再把该序列的下一个元素压入（或 replaceTop），每步下沉一次，每层要比较两次（两个孩子比较、再和自己比较）
+// 败者树是一棵完全二叉树，k 个叶子是各序列的当前头部，每个内部节点记录“在这里比赛输掉的那个序列”，根上面再记录总冠军：
+// 冠军输出后，它所在序列换上下一个元素，只需沿着它的叶子到根的路径重赛：每层和路径上记录的败者比一次，赢的继续往上，输的留下
+// 每层只比较一次，一共 log k 次，而且路径上要比较的对象是固定的，不需要像堆那样先比较兄弟
+// 比较本身很贵（字符串、多字段的记录）时，比较次数减半的好处最明显；对 int 这种比较很便宜的类型，
+// 两者的耗时主要花在分支预测失败上，差别不大，main 里的测试给出了实际数字
+
+// 下面的 KWayMerge 接受 k 对 input iterator，每个序列只读一遍，只保存每个序列的当前头部，内存 O(k)
+// 总共 O(n log k) 时间。相等的元素按序列编号先后输出（稳定）
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#define BINARY_HEAP_NO_MAIN
+#include "BinaryHeap.cpp"
+
+template<class InputIt, class Compare = std::less<typename std::iterator_traits<InputIt>::value_type>>
+class KWayMerge {
+public:
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
+private:
+    // 树上的每个节点直接保存败者的头部元素，重赛时不需要再按序列编号去别处取值
+    struct Entry {
+        value_type key;
+        int run;           // 序列编号；建树时 k 表示虚拟的负无穷
+        bool exhausted;    // 序列已经读完，当作正无穷
+    };
+
+    int k;
+    std::vector<InputIt> current;    // 各序列的读取位置
+    std::vector<InputIt> ends;
+    std::vector<Entry> tree;         // tree[0] 是冠军，tree[1 .. k-1] 是各内部节点上的败者
+    Compare comp;
+
+    // a 是否应该排在 b 前面
+    bool beats(const Entry &a, const Entry &b) const {
+        if (a.exhausted || b.exhausted) {
+            return !a.exhausted;
+        }
+        if (comp(a.key, b.key)) {
+            return true;
+        }
+        return !comp(b.key, a.key) && a.run < b.run;    // 相等时编号小的先输出
+    }
+
+    // 序列 winner.run 换上了新的头部，沿着叶子到根的路径重赛，每层和留在那里的败者比一次
+    // 叶子 run 的父节点是 (run + k) / 2，和堆的下标规则一样
+    // building 为 true 时在建树：编号 k 是负无穷，谁都赢不了它。建好之后树里不再有负无穷，热路径上省掉这个判断
+    template<bool building>
+    void replay(Entry winner) {
+        for (int node = (winner.run + k) / 2; node > 0; node /= 2) {
+            Entry &loser = tree[node];
+            bool loserWins = building ? loser.run == k || (winner.run != k && beats(loser, winner))
+                                      : beats(loser, winner);
+            if (loserWins) {
+                std::swap(loser, winner);    // 原来的败者这次赢了，继续往上；刚来的留在这里
+            }
+        }
+        tree[0] = std::move(winner);
+    }
+
+    // 读出序列 run 的下一个元素（input iterator 前进后就不能再解引用之前的位置，所以复制一份）
+    Entry readHead(int run) {
+        Entry entry{value_type(), run, current[run] == ends[run]};
+        if (!entry.exhausted) {
+            entry.key = *current[run];
+            ++current[run];
+        }
+        return entry;
+    }
+
+public:
+    // runs 中的每一对 [first, last) 都必须按 compare 有序
+    explicit KWayMerge(const std::vector<std::pair<InputIt, InputIt>> &runs, const Compare &compare = Compare())
+        : k(runs.size()), comp(compare) {
+        for (const auto &run : runs) {
+            current.push_back(run.first);
+            ends.push_back(run.second);
+        }
+        // 先让所有节点都记录负无穷，再逐个加入真实的序列：每加入一个，它会一路打到第一个负无穷所在的节点，留在那里，
+        // 负无穷继续往上。全部加入后，负无穷都被挤出去了
+        tree.assign(std::max(k, 1), Entry{value_type(), k, false});
+        for (int i = k - 1; i >= 0; --i) {
+            replay<true>(readHead(i));
+        }
+    }
+
+    bool isEmpty() const {
+        return k == 0 || tree[0].exhausted;
+    }
+
+    // 下一个要输出的元素，为空时抛出 std::runtime_error
+    const value_type &peek() const {
+        if (isEmpty()) {
+            throw std::runtime_error("KWayMerge is empty. Cannot peek.");
+        }
+        return tree[0].key;
+    }
+
+    // 输出下一个元素，为空时抛出 std::runtime_error
+    value_type next() {
+        if (isEmpty()) {
+            throw std::runtime_error("KWayMerge is empty. Cannot get next.");
+        }
+        value_type result = std::move(tree[0].key);
+        replay<false>(readHead(tree[0].run));
+        return result;
+    }
+
+    // 把剩下的元素全部写到 out
+    template<class OutputIt>
+    OutputIt drainTo(OutputIt out) {
+        while (!isEmpty()) {
+            *out++ = next();
+        }
+        return out;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 KWayMerge
+// 它们在 #include 之前定义 LOSER_TREE_NO_MAIN，跳过下面的测试代码和 main
+#ifndef LOSER_TREE_NO_MAIN
+
+// 同样的 k 路归并，用 MinHeap + replaceTop 实现，作为对照
+std::vector<int> heapMerge(const std::vector<std::vector<int>> &runs) {
+    std::vector<std::pair<int, int>> heads;    // (值, 序列编号)
+    std::vector<size_t> positions(runs.size(), 1);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!runs[i].empty()) {
+            heads.push_back({runs[i][0], static_cast<int>(i)});
+        }
+    }
+    MinHeap<std::pair<int, int>> heap(heads.begin(), heads.end());
+    std::vector<int> merged;
+    while (!heap.isEmpty()) {
+        std::pair<int, int> top = heap.peek();
+        merged.push_back(top.first);
+        int run = top.second;
+        if (positions[run] < runs[run].size()) {
+            heap.replaceTop({runs[run][positions[run]++], run});
+        } else {
+            heap.extractMin();
+        }
+    }
+    return merged;
+}
+
+void benchmarkMerge(int k, int runLength) {
+    std::vector<std::vector<int>> runs(k, std::vector<int>(runLength));
+    unsigned seed = 2024;
+    for (auto &run : runs) {
+        for (int &v : run) {
+            seed = seed * 1664525u + 1013904223u;
+            v = static_cast<int>(seed >> 2);
+        }
+        std::sort(run.begin(), run.end());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::vector<int>::const_iterator, std::vector<int>::const_iterator>> ranges;
+    for (const auto &run : runs) {
+        ranges.push_back({run.begin(), run.end()});
+    }
+    KWayMerge<std::vector<int>::const_iterator> merger(ranges);
+    std::vector<int> byLoserTree;
+    byLoserTree.reserve(static_cast<size_t>(k) * runLength);
+    merger.drainTo(std::back_inserter(byLoserTree));
+    auto loserDone = std::chrono::steady_clock::now();
+
+    std::vector<int> byHeap = heapMerge(runs);
+    auto heapDone = std::chrono::steady_clock::now();
+
+    std::vector<int> bySort;
+    bySort.reserve(static_cast<size_t>(k) * runLength);
+    for (const auto &run : runs) {
+        bySort.insert(bySort.end(), run.begin(), run.end());
+    }
+    std::sort(bySort.begin(), bySort.end());
+    auto sortDone = std::chrono::steady_clock::now();
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    bool same = byLoserTree == byHeap && byLoserTree == bySort;
+    std::cout << "  k = " << k << ": loser tree " << ms(start, loserDone) << " ms, MinHeap + replaceTop "
+              << ms(loserDone, heapDone) << " ms, concatenate + sort " << ms(heapDone, sortDone) << " ms, "
+              << (same ? "same result" : "RESULTS DIFFER") << std::endl;
+}
+
+int main() {
+    // 三个输入流，边读边归并
+    std::istringstream a("1 4 7 10"), b("2 5 8"), c("0 3 6 9 12");
+    typedef std::istream_iterator<int> StreamIt;
+    KWayMerge<StreamIt> merger({{StreamIt(a), StreamIt()}, {StreamIt(b), StreamIt()}, {StreamIt(c), StreamIt()}});
+    std::cout << "Merged streams: ";
+    merger.drainTo(std::ostream_iterator<int>(std::cout, " "));
+    std::cout << std::endl;    // 0 1 2 3 4 5 6 7 8 9 10 12
+
+    // 降序序列，用 std::greater
+    std::vector<int> d = {9, 5, 1}, e = {8, 6}, f = {};
+    typedef std::vector<int>::iterator VecIt;
+    KWayMerge<VecIt, std::greater<int>> descending({{d.begin(), d.end()}, {e.begin(), e.end()}, {f.begin(), f.end()}});
+    std::cout << "Merged descending: ";
+    while (!descending.isEmpty()) {
+        std::cout << descending.next() << " ";
+    }
+    std::cout << std::endl;    // 9 8 6 5 1
+
+    std::cout << "\n--- k-way merge of 2^22 ints ---" << std::endl;
+    for (int k : {4, 64, 1024}) {
+        benchmarkMerge(k, (1 << 22) / k);
+    }
+
+    return 0;
+}
+
+#endif    // LOSER_TREE_NO_MAIN
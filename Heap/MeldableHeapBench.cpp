@@ -0,0 +1,249 @@
+// 可合并堆的对比：二项队列、配对堆、斐波那契堆
+// 三者都支持 insert / findMin / deleteMin / merge，配对堆和斐波那契堆还支持基于句柄的 decreaseKey
+
+//                 insert        merge        decreaseKey     deleteMin
+// 二项队列        O(log n)      O(log n)     不支持           O(log n)
+// 配对堆          O(1)          O(1)         均摊 o(log n)    均摊 O(log n)
+// 斐波那契堆      O(1)          O(1)         均摊 O(1)        均摊 O(log n)
+
+// 两种负载：
+// 1. Dijkstra：大量 decreaseKey。二项队列没有 decreaseKey，只能用惰性删除（重复插入，弹出时跳过过期的）
+// 2. 事件模拟（hold 模型）：队列大小保持不变，反复“取出最早的事件，安排一个更晚的新事件”，
+//    并且定期把一批新事件组成的队列 merge 进来
+// 每种负载三个堆的结果（校验和）必须相同
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define BINOMIAL_QUEUE_NO_MAIN
+#include "BinomialQueue.cpp"
+#define PAIRING_HEAP_NO_MAIN
+#include "PairingHeap.cpp"
+#define FIBONACCI_HEAP_NO_MAIN
+#include "FibonacciHeap.cpp"
+
+// 线性同余随机数，保证每次运行、每个堆拿到的数据都一样
+struct Lcg {
+    unsigned long long state;
+
+    explicit Lcg(unsigned long long seed) : state(seed) {}
+
+    unsigned next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned>(state >> 33);
+    }
+};
+
+// 压缩邻接表（CSR）：顶点 u 的出边是 edges[offsets[u]] ~ edges[offsets[u + 1] - 1]
+struct CsrGraph {
+    int vertexNum;
+    std::vector<int> offsets;
+    std::vector<std::pair<int, int>> edges;    // (to, weight)
+};
+
+// 随机有向图：先连一条 0 -> 1 -> ... -> n-1 的链保证可达，再随机加边，边权在 [1, maxWeight] 之间
+CsrGraph makeRandomGraph(int n, int m, int maxWeight, unsigned long long seed) {
+    Lcg rng(seed);
+    std::vector<std::pair<int, std::pair<int, int>>> edgeList;
+    for (int u = 0; u + 1 < n; ++u) {
+        edgeList.push_back({u, {u + 1, static_cast<int>(rng.next() % maxWeight) + 1}});
+    }
+    while (edgeList.size() < static_cast<size_t>(m)) {
+        int u = rng.next() % n;
+        int v = rng.next() % n;
+        edgeList.push_back({u, {v, static_cast<int>(rng.next() % maxWeight) + 1}});
+    }
+
+    CsrGraph graph;
+    graph.vertexNum = n;
+    graph.offsets.assign(n + 1, 0);
+    for (const auto &e : edgeList) {
+        graph.offsets[e.first + 1]++;
+    }
+    for (int u = 0; u < n; ++u) {
+        graph.offsets[u + 1] += graph.offsets[u];
+    }
+    graph.edges.resize(edgeList.size());
+    std::vector<int> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto &e : edgeList) {
+        graph.edges[fill[e.first]++] = e.second;
+    }
+    return graph;
+}
+
+struct BenchResult {
+    long long checksum;
+    long long heapOps;    // insert + decreaseKey + deleteMin 的次数
+    double ms;
+};
+
+// 带 decreaseKey 的 Dijkstra：每个顶点在堆里最多一份，通过句柄更新
+template<class Heap>
+BenchResult dijkstraDecreaseKey(const CsrGraph &graph) {
+    auto start = std::chrono::steady_clock::now();
+    const long long INF = 1LL << 60;
+    std::vector<long long> dist(graph.vertexNum, INF);
+    std::vector<typename Heap::Handle> handles(graph.vertexNum, nullptr);
+    std::vector<bool> done(graph.vertexNum, false);
+    long long heapOps = 0;
+
+    Heap heap;
+    dist[0] = 0;
+    handles[0] = heap.insert({0, 0});
+    ++heapOps;
+    while (!heap.isEmpty()) {
+        std::pair<long long, int> top;
+        heap.deleteMin(top);
+        ++heapOps;
+        int u = top.second;
+        done[u] = true;
+        for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; ++i) {
+            int v = graph.edges[i].first;
+            long long newDist = top.first + graph.edges[i].second;
+            if (done[v] || newDist >= dist[v]) {
+                continue;
+            }
+            if (dist[v] == INF) {
+                handles[v] = heap.insert({newDist, v});
+            } else {
+                heap.decreaseKey(handles[v], {newDist, v});
+            }
+            dist[v] = newDist;
+            ++heapOps;
+        }
+    }
+
+    long long checksum = 0;
+    for (long long d : dist) {
+        checksum += d;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return {checksum, heapOps, std::chrono::duration<double, std::milli>(end - start).count()};
+}
+
+// 惰性删除的 Dijkstra：距离变小时再插入一份，弹出时跳过已经确定的顶点
+template<class Heap>
+BenchResult dijkstraLazy(const CsrGraph &graph) {
+    auto start = std::chrono::steady_clock::now();
+    const long long INF = 1LL << 60;
+    std::vector<long long> dist(graph.vertexNum, INF);
+    std::vector<bool> done(graph.vertexNum, false);
+    long long heapOps = 0;
+
+    Heap heap;
+    dist[0] = 0;
+    heap.insert({0, 0});
+    ++heapOps;
+    while (!heap.isEmpty()) {
+        std::pair<long long, int> top;
+        heap.deleteMin(top);
+        ++heapOps;
+        int u = top.second;
+        if (done[u]) {
+            continue;
+        }
+        done[u] = true;
+        for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; ++i) {
+            int v = graph.edges[i].first;
+            long long newDist = top.first + graph.edges[i].second;
+            if (newDist < dist[v]) {
+                dist[v] = newDist;
+                heap.insert({newDist, v});
+                ++heapOps;
+            }
+        }
+    }
+
+    long long checksum = 0;
+    for (long long d : dist) {
+        checksum += d;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return {checksum, heapOps, std::chrono::duration<double, std::milli>(end - start).count()};
+}
+
+// 事件模拟中用来 merge 的批量队列
+// 二项队列的批量队列和主队列共用节点池，merge 时只挂指针，不复制节点
+template<class Heap>
+std::unique_ptr<Heap> makeBatchQueue(Heap &) {
+    return std::unique_ptr<Heap>(new Heap());
+}
+
+template<class Comparable>
+std::unique_ptr<BinomialQueue<Comparable>> makeBatchQueue(BinomialQueue<Comparable> &heap) {
+    return std::unique_ptr<BinomialQueue<Comparable>>(new BinomialQueue<Comparable>(heap.nodePool()));
+}
+
+// hold 模型的事件模拟：队列里始终有 pending 个事件
+// 每一步取出最早的事件（时间 t），安排一个 t + [1, 1000] 的新事件；
+// 每 meldEvery 步，新建一个含 meldBatch 个事件的队列 merge 进来，再多取出同样多的事件，保持队列大小不变
+template<class Heap>
+BenchResult eventSimulation(int pending, int steps, int meldEvery, int meldBatch) {
+    auto start = std::chrono::steady_clock::now();
+    Lcg rng(7);
+    long long heapOps = 0;
+    long long checksum = 0;
+
+    Heap heap;
+    for (int i = 0; i < pending; ++i) {
+        heap.insert(static_cast<long long>(rng.next() % 1000000));
+        ++heapOps;
+    }
+    for (int step = 1; step <= steps; ++step) {
+        long long now;
+        heap.deleteMin(now);
+        heap.insert(now + rng.next() % 1000 + 1);
+        heapOps += 2;
+        checksum += now;
+
+        if (step % meldEvery == 0) {
+            std::unique_ptr<Heap> batch = makeBatchQueue(heap);
+            for (int i = 0; i < meldBatch; ++i) {
+                batch->insert(now + rng.next() % 1000000);
+            }
+            heap.merge(*batch);
+            for (int i = 0; i < meldBatch; ++i) {
+                long long t;
+                heap.deleteMin(t);
+                checksum += t;
+            }
+            heapOps += 2 * meldBatch;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return {checksum, heapOps, std::chrono::duration<double, std::milli>(end - start).count()};
+}
+
+void printResult(const std::string &name, const BenchResult &result) {
+    std::cout << "  " << name << ": " << result.ms << " ms, " << result.heapOps << " heap ops, "
+              << result.heapOps / result.ms / 1000 << " Mops/s, checksum " << result.checksum << std::endl;
+}
+
+int main() {
+    typedef std::pair<long long, int> DistVertex;
+
+    // 边权范围大、平均出度 10，decreaseKey 比较多
+    const int n = 200000;
+    const int m = 2000000;
+    CsrGraph graph = makeRandomGraph(n, m, 100000, 2024);
+    std::cout << "Dijkstra on a random graph, " << n << " vertices, " << m << " edges:" << std::endl;
+    printResult("BinomialQueue (lazy)", dijkstraLazy<BinomialQueue<DistVertex>>(graph));
+    printResult("PairingHeap   (lazy)", dijkstraLazy<PairingHeap<DistVertex>>(graph));
+    printResult("PairingHeap         ", dijkstraDecreaseKey<PairingHeap<DistVertex>>(graph));
+    printResult("FibonacciHeap       ", dijkstraDecreaseKey<FibonacciHeap<DistVertex>>(graph));
+
+    const int pending = 100000;
+    const int steps = 1000000;
+    std::cout << "\nEvent simulation, " << pending << " pending events, " << steps
+              << " steps, meld 1000 events every 1000 steps:" << std::endl;
+    printResult("BinomialQueue       ", eventSimulation<BinomialQueue<long long>>(pending, steps, 1000, 1000));
+    printResult("PairingHeap         ", eventSimulation<PairingHeap<long long>>(pending, steps, 1000, 1000));
+    printResult("FibonacciHeap       ", eventSimulation<FibonacciHeap<long long>>(pending, steps, 1000, 1000));
+
+    return 0;
+}
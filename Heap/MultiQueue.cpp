@@ -0,0 +1,297 @@
+// 并发的松弛优先队列（MultiQueue）
+// 一个加了互斥锁的 MinHeap 在多线程下是完全串行的：所有线程抢同一把锁，锁所在的 cache line 在核之间来回传递
+// MultiQueue 放弃“每次都取出全局最小”的保证，换取可扩展性：
+// 1. 内部有 c * P 个 MinHeap（P 是线程数，c 是每个线程对应的堆个数，通常取 2~4），每个堆有自己的锁
+// 2. push：随机选一个堆，try_lock 成功就插进去，失败（别的线程正在用）就换一个堆重试
+// 3. pop：随机选两个堆，都 try_lock 成功后，比较两个堆顶，取较小的那个弹出（two-choice）
+//    只看一个随机堆的话，取出的元素和全局最小差得很远；看两个就能把误差控制住
+// 线程之间几乎不会争同一把锁，拿不到锁时也不会阻塞，而是换一个堆
+
+// rank 误差（rank error）：pop 返回的元素在当时队列中从小到大排第几（从 0 开始），严格的优先队列永远是 0
+// 对于 n = c * P 个堆的 two-choice MultiQueue，期望的 rank 误差是 O(n)，并且以高概率不超过 O(n log n)
+// （Rihani, Sanders, Dementiev 2015 提出，Alistarh 等人 2017 给出证明）
+// 也就是说，误差只和堆的个数有关，和队列里元素的个数无关。main 中实测了不同 n 下的平均和最大 rank 误差
+// 对于任务调度这类“大致按优先级”就够用的场景，这个误差是可以接受的
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#define BINARY_HEAP_NO_MAIN
+#include "BinaryHeap.cpp"
+
+template<class T, class Compare = std::less<T>, int D = 2>
+class MultiQueue {
+private:
+    // 每个堆和它的锁单独占 cache line，避免不同线程操作相邻的堆时发生伪共享
+    struct alignas(64) Shard {
+        std::mutex lock;
+        MinHeap<T, Compare, D> heap;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    int numShards;
+    Compare comp;
+    std::atomic<long long> count;    // 所有堆的元素总数，用来判断整个队列是否为空
+
+    // 每个线程自己的随机数状态（xorshift64），不需要同步
+    static uint64_t nextRandom() {
+        thread_local uint64_t state =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9e3779b97f4a7c15ULL | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    int randomShard() const {
+        return nextRandom() % numShards;
+    }
+
+    // 两个随机堆都为空的情况连续出现太多次时，逐个检查所有堆，确认队列确实空了还是只是运气不好
+    bool popFromAnyShard(T &out) {
+        for (int i = 0; i < numShards; ++i) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            if (!shards[i].heap.isEmpty()) {
+                out = shards[i].heap.extractMin();
+                count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    // numThreads 是预期的并发线程数 P，queuesPerThread 是 c，共 c * P 个堆（至少 2 个）
+    explicit MultiQueue(int numThreads, int queuesPerThread = 2, const Compare &compare = Compare())
+        : numShards(std::max(2, numThreads * queuesPerThread)), comp(compare), count(0) {
+        if (numThreads < 1 || queuesPerThread < 1) {
+            throw std::invalid_argument("MultiQueue: numThreads and queuesPerThread must be positive.");
+        }
+        shards.reset(new Shard[numShards]);
+    }
+
+    MultiQueue(const MultiQueue &) = delete;
+    MultiQueue &operator=(const MultiQueue &) = delete;
+
+    void push(const T &value) {
+        while (true) {
+            Shard &shard = shards[randomShard()];
+            if (shard.lock.try_lock()) {
+                shard.heap.insert(value);
+                shard.lock.unlock();
+                count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    // 取出一个较小的元素放到 out 中，不保证是全局最小（见文件开头的 rank 误差）
+    // 队列为空时返回 false。和其他线程的 push 并发时，“空”只是调用那一刻的近似判断
+    bool tryPop(T &out) {
+        int emptyDraws = 0;
+        while (count.load(std::memory_order_relaxed) > 0) {
+            int i = randomShard();
+            int j = randomShard();
+            if (i == j) {
+                continue;
+            }
+            if (!shards[i].lock.try_lock()) {
+                continue;
+            }
+            if (!shards[j].lock.try_lock()) {
+                shards[i].lock.unlock();
+                continue;
+            }
+
+            MinHeap<T, Compare, D> &a = shards[i].heap;
+            MinHeap<T, Compare, D> &b = shards[j].heap;
+            MinHeap<T, Compare, D> *best = nullptr;
+            if (!a.isEmpty() && (b.isEmpty() || !comp(b.peek(), a.peek()))) {
+                best = &a;
+            } else if (!b.isEmpty()) {
+                best = &b;
+            }
+            if (best != nullptr) {
+                out = best->extractMin();
+            }
+            shards[j].lock.unlock();
+            shards[i].lock.unlock();
+
+            if (best != nullptr) {
+                count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (++emptyDraws >= numShards) {
+                return popFromAnyShard(out);
+            }
+        }
+        return false;
+    }
+
+    // 近似的元素个数，有并发操作时只是一个快照
+    long long size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    int queueCount() const {
+        return numShards;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 MultiQueue
+// 它们在 #include 之前定义 MULTI_QUEUE_NO_MAIN，跳过下面的测试代码和 main
+#ifndef MULTI_QUEUE_NO_MAIN
+
+// 对照组：一个 MinHeap 加一把锁
+template<class T>
+class LockedHeap {
+private:
+    std::mutex lock;
+    MinHeap<T> heap;
+
+public:
+    void push(const T &value) {
+        std::lock_guard<std::mutex> guard(lock);
+        heap.insert(value);
+    }
+
+    bool tryPop(T &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (heap.isEmpty()) {
+            return false;
+        }
+        out = heap.extractMin();
+        return true;
+    }
+};
+
+// 树状数组，统计比某个值小的剩余元素个数，用来计算 rank 误差
+class FenwickTree {
+private:
+    std::vector<int> tree;
+
+public:
+    explicit FenwickTree(int n) : tree(n + 1, 0) {}
+
+    void add(int index, int delta) {
+        for (++index; index < static_cast<int>(tree.size()); index += index & -index) {
+            tree[index] += delta;
+        }
+    }
+
+    // [0, index) 中的元素个数
+    int prefixSum(int index) const {
+        int sum = 0;
+        for (; index > 0; index -= index & -index) {
+            sum += tree[index];
+        }
+        return sum;
+    }
+};
+
+// 单线程测量 rank 误差：放入 0 ~ n-1 的一个随机排列，再全部取出，统计每次取出时有多少更小的元素还在队列里
+// 并发时线程交错会额外带来一点误差，但主要部分由堆的个数决定，这里单独测量
+void measureRankError(int numThreads, int n) {
+    MultiQueue<int> mq(numThreads);
+    std::vector<int> values(n);
+    for (int i = 0; i < n; ++i) {
+        values[i] = i;
+    }
+    uint64_t seed = 12345;
+    for (int i = n - 1; i > 0; --i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::swap(values[i], values[(seed >> 33) % (i + 1)]);
+    }
+
+    FenwickTree remaining(n);
+    for (int v : values) {
+        mq.push(v);
+        remaining.add(v, 1);
+    }
+    long long totalError = 0;
+    int maxError = 0;
+    int v;
+    while (mq.tryPop(v)) {
+        int error = remaining.prefixSum(v);
+        totalError += error;
+        maxError = std::max(maxError, error);
+        remaining.add(v, -1);
+    }
+    std::cout << "  " << mq.queueCount() << " queues (P = " << numThreads << "): mean rank error "
+              << static_cast<double>(totalError) / n << ", max " << maxError << std::endl;
+}
+
+// 每个线程交替 push 和 pop（先预填充），统计总吞吐量
+template<class Queue>
+double measureThroughput(Queue &queue, int numThreads, int opsPerThread) {
+    for (int i = 0; i < 100000; ++i) {
+        queue.push(i * 7919 % 1000003);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&queue, t, opsPerThread]() {
+            uint64_t seed = t + 1;
+            int value;
+            for (int i = 0; i < opsPerThread / 2; ++i) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                queue.push(static_cast<int>(seed >> 44));
+                queue.tryPop(value);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(numThreads) * opsPerThread / seconds / 1e6;
+}
+
+int main() {
+    std::cout << "--- MultiQueue basic ---" << std::endl;
+    MultiQueue<int> mq(2);
+    for (int x : {10, 20, 5, 30, 15, 2, 7}) {
+        mq.push(x);
+    }
+    std::cout << "Queues: " << mq.queueCount() << ", size: " << mq.size() << std::endl;
+    std::cout << "Pop order (relaxed): ";
+    int value;
+    while (mq.tryPop(value)) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "\n--- Rank error, 1000000 elements, c = 2 ---" << std::endl;
+    for (int p : {1, 2, 4, 8, 16}) {
+        measureRankError(p, 1000000);
+    }
+
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\n--- Throughput (push + pop), " << hardwareThreads << " hardware threads ---" << std::endl;
+    const int opsPerThread = 2000000;
+    for (int p = 1; p <= static_cast<int>(std::max(8u, hardwareThreads)); p *= 2) {
+        LockedHeap<int> locked;
+        MultiQueue<int> relaxed(p);
+        double lockedMops = measureThroughput(locked, p, opsPerThread);
+        double relaxedMops = measureThroughput(relaxed, p, opsPerThread);
+        std::cout << "  " << p << " threads: locked MinHeap " << lockedMops << " Mops/s, MultiQueue " << relaxedMops
+                  << " Mops/s" << std::endl;
+    }
+
+    return 0;
+}
+
+#endif    // MULTI_QUEUE_NO_MAIN
@@ -0,0 +1,251 @@
+// 配对堆（Pairing Heap）
+// 一棵满足最小堆性质的多叉树，和二项队列一样用 leftChild / nextSibling 表示孩子链表
+// 它没有任何形状上的约束，所有操作都只靠一个基本动作：link（两棵树比较根，大的那棵挂到小的下面，成为最左孩子）
+
+// 各操作：
+// 1. insert：新节点自成一棵树，和根 link，O(1)
+// 2. merge：两个根 link，O(1)。二项队列要像二进制加法一样逐阶合并，O(log n)
+// 3. decreaseKey：把节点连同子树从父亲那里剪下来，改 key 后和根 link，O(1)（均摊 o(log n)）
+//    为了 O(1) 剪下子树，每个节点多一个 prev 指针：最左孩子的 prev 指向父亲，其余孩子的 prev 指向左兄弟
+// 4. deleteMin：删掉根，它的孩子们变成一串树，用“两趟合并”合成一棵：
+//    第一趟从左到右两两 link，第二趟从右到左把结果逐个 link 到一起，均摊 O(log n)
+//    如果只从左到右逐个 link，会退化成一条链，之后每次 deleteMin 都是 O(n)
+
+// 和斐波那契堆相比，配对堆的理论界稍差，但节点小、常数小，实践中通常更快，见 MeldableHeapBench.cpp
+
+// 句柄（Handle）：insert 返回指向节点的句柄，decreaseKey 通过句柄直接找到节点，不需要查找
+// 句柄在对应元素被 deleteMin 删除、或 makeEmpty 之后失效
+
+#include <iostream>
+#include <stdexcept>    // For std::underflow_error
+#include <utility>      // For std::swap
+#include <vector>
+
+template<class Comparable>
+class PairingHeap {
+private:
+    struct PairNode {
+        Comparable element;
+        PairNode *leftChild;
+        PairNode *nextSibling;
+        PairNode *prev;    // 最左孩子指向父节点，其余节点指向左兄弟；根为 nullptr
+
+        PairNode(const Comparable &theElement)
+            : element(theElement), leftChild(nullptr), nextSibling(nullptr), prev(nullptr) {}
+    };
+
+    PairNode *root;
+    int currentSize;
+    std::vector<PairNode *> treeArray;    // 两趟合并的工作区，作为成员复用，避免每次 deleteMin 都分配
+
+    // 把两棵树合成一棵，返回新根。first 和 second 都必须是独立的树（没有 prev 和 nextSibling）
+    // 根较大的那棵成为另一棵的最左孩子
+    PairNode *link(PairNode *first, PairNode *second) {
+        if (second->element < first->element) {
+            std::swap(first, second);
+        }
+        second->prev = first;
+        second->nextSibling = first->leftChild;
+        if (first->leftChild != nullptr) {
+            first->leftChild->prev = second;
+        }
+        first->leftChild = second;
+        return first;
+    }
+
+    // 两趟合并：把 firstSibling 开头的一串兄弟树合成一棵，返回新根
+    PairNode *combineSiblings(PairNode *firstSibling) {
+        if (firstSibling == nullptr) {
+            return nullptr;
+        }
+
+        // 先把兄弟链拆成一棵棵独立的树
+        treeArray.clear();
+        while (firstSibling != nullptr) {
+            PairNode *next = firstSibling->nextSibling;
+            firstSibling->prev = nullptr;
+            firstSibling->nextSibling = nullptr;
+            treeArray.push_back(firstSibling);
+            firstSibling = next;
+        }
+
+        // 第一趟：从左到右两两 link，结果依次放回数组前半部分
+        int numSiblings = treeArray.size();
+        int numPairs = 0;
+        for (int i = 0; i + 1 < numSiblings; i += 2) {
+            treeArray[numPairs++] = link(treeArray[i], treeArray[i + 1]);
+        }
+        if (numSiblings % 2 == 1) {
+            treeArray[numPairs++] = treeArray[numSiblings - 1];    // 落单的最后一棵
+        }
+
+        // 第二趟：从右到左，把每棵树 link 到累积的结果上
+        PairNode *result = treeArray[numPairs - 1];
+        for (int i = numPairs - 2; i >= 0; --i) {
+            result = link(treeArray[i], result);
+        }
+        return result;
+    }
+
+    // 把以 t 为根的子树从树中剪下来，t 不能是根
+    void cut(PairNode *t) {
+        if (t->prev->leftChild == t) {
+            t->prev->leftChild = t->nextSibling;    // t 是最左孩子，prev 是父节点
+        } else {
+            t->prev->nextSibling = t->nextSibling;  // prev 是左兄弟
+        }
+        if (t->nextSibling != nullptr) {
+            t->nextSibling->prev = t->prev;
+        }
+        t->prev = nullptr;
+        t->nextSibling = nullptr;
+    }
+
+    // 释放整棵树，不用递归
+    // 把 leftChild / nextSibling 看成二叉树的左右孩子：有左孩子就右旋，把左孩子转到上面；没有左孩子就删掉当前节点，走向右孩子
+    // 每次右旋都让一个节点离开左链，所以总共 O(n)，也不需要额外的栈。配对堆的树可能很深，递归容易爆栈
+    void destroy(PairNode *t) {
+        while (t != nullptr) {
+            if (t->leftChild == nullptr) {
+                PairNode *next = t->nextSibling;
+                delete t;
+                t = next;
+            } else {
+                PairNode *child = t->leftChild;
+                t->leftChild = child->nextSibling;
+                child->nextSibling = t;
+                t = child;
+            }
+        }
+    }
+
+public:
+    using Handle = PairNode *;    // insert 返回的句柄，用于 decreaseKey
+
+    PairingHeap() : root(nullptr), currentSize(0) {}
+
+    // 句柄指向的是节点本身，拷贝后的堆和原来的句柄对应不上，所以禁止拷贝
+    PairingHeap(const PairingHeap &) = delete;
+    PairingHeap &operator=(const PairingHeap &) = delete;
+
+    ~PairingHeap() {
+        makeEmpty();
+    }
+
+    bool isEmpty() const {
+        return root == nullptr;
+    }
+
+    int size() const {
+        return currentSize;
+    }
+
+    // 返回最小元素，队列为空时抛出 std::underflow_error
+    const Comparable &findMin() const {
+        if (isEmpty()) {
+            throw std::underflow_error("PairingHeap is empty, cannot find minimum.");
+        }
+        return root->element;
+    }
+
+    Handle insert(const Comparable &x) {
+        PairNode *newNode = new PairNode(x);
+        root = (root == nullptr) ? newNode : link(root, newNode);
+        ++currentSize;
+        return newNode;
+    }
+
+    void deleteMin() {
+        if (isEmpty()) {
+            throw std::underflow_error("PairingHeap is empty, cannot delete minimum.");
+        }
+        PairNode *oldRoot = root;
+        root = combineSiblings(root->leftChild);
+        delete oldRoot;
+        --currentSize;
+    }
+
+    void deleteMin(Comparable &minItem) {
+        minItem = findMin();
+        deleteMin();
+    }
+
+    // 把句柄 p 对应元素的值减小为 newVal，newVal 比原值大时抛出 std::invalid_argument
+    void decreaseKey(Handle p, const Comparable &newVal) {
+        if (p->element < newVal) {
+            throw std::invalid_argument("PairingHeap: decreaseKey cannot increase a key.");
+        }
+        p->element = newVal;
+        if (p != root) {
+            cut(p);
+            root = link(root, p);
+        }
+    }
+
+    // 将 rhs 合并到当前堆，rhs 变为空，rhs 的句柄继续有效，属于当前堆
+    void merge(PairingHeap &rhs) {
+        if (this == &rhs || rhs.root == nullptr) {
+            return;
+        }
+        root = (root == nullptr) ? rhs.root : link(root, rhs.root);
+        currentSize += rhs.currentSize;
+        rhs.root = nullptr;
+        rhs.currentSize = 0;
+    }
+
+    void makeEmpty() {
+        destroy(root);
+        root = nullptr;
+        currentSize = 0;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 PairingHeap
+// 它们在 #include 之前定义 PAIRING_HEAP_NO_MAIN，跳过下面的 main
+#ifndef PAIRING_HEAP_NO_MAIN
+
+int main() {
+    PairingHeap<int> heap;
+    std::cout << "Inserting 10, 20, 5, 30, 15, 2, 7..." << std::endl;
+    std::vector<PairingHeap<int>::Handle> handles;
+    for (int x : {10, 20, 5, 30, 15, 2, 7}) {
+        handles.push_back(heap.insert(x));
+    }
+    std::cout << "Min element: " << heap.findMin() << std::endl;    // 2
+
+    std::cout << "\nDecreasing 30 to 1..." << std::endl;
+    heap.decreaseKey(handles[3], 1);
+    std::cout << "Min element: " << heap.findMin() << std::endl;    // 1
+
+    PairingHeap<int> other;
+    std::cout << "\nMerging a heap with 4, 12, 0..." << std::endl;
+    for (int x : {4, 12, 0}) {
+        other.insert(x);
+    }
+    heap.merge(other);
+    std::cout << "Min element: " << heap.findMin() << ", size: " << heap.size()
+              << ", other is empty: " << (other.isEmpty() ? "true" : "false") << std::endl;
+
+    std::cout << "\nDeleting all: ";
+    while (!heap.isEmpty()) {
+        int minItem;
+        heap.deleteMin(minItem);
+        std::cout << minItem << " ";
+    }
+    std::cout << std::endl;    // 0 1 2 4 5 7 10 12 15 20
+
+    // 递减插入时，每个新节点都成为新根，旧根是它唯一的孩子，树退化成一条深度为 n 的链
+    // 递归释放会爆栈，destroy 的右旋写法没有这个问题
+    for (int i = 1000000; i > 0; --i) {
+        heap.insert(i);
+    }
+    heap.deleteMin();
+    std::cout << "\nAfter 1000000 decreasing inserts and one deleteMin, min: " << heap.findMin()
+              << ", size: " << heap.size() << std::endl;
+    heap.makeEmpty();
+    std::cout << "Made empty: " << (heap.isEmpty() ? "true" : "false") << std::endl;
+
+    return 0;
+}
+
+#endif    // PAIRING_HEAP_NO_MAIN
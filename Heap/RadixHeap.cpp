@@ -0,0 +1,169 @@
+// 基数堆（Radix Heap）
+// 适用于“单调”的优先队列：取出的最小键值 last 不会减小，之后插入的键值都不小于 last
+// Dijkstra 正好满足这一点（边权非负时，新距离 = 当前出堆的距离 + 边权 >= 当前出堆的距离）
+
+// 结构：按“和 last 的最高不同二进制位”分桶
+// 键值 key 放进第 bucketIndex(key) 个桶：key == last 时放 0 号桶，否则放 (key ^ last) 的最高位位置 + 1 号桶
+// 例如 last = 0b1000，key = 0b1011，异或为 0b0011，最高位是第 1 位，放进 2 号桶
+// 所以第 i 个桶（i >= 1）里的键值都和 last 的高位相同，只有第 i-1 位不同且 key 更大：桶号越小，键值越小
+
+// 1. insert：算出桶号放进去，O(1)
+// 2. extractMin：0 号桶非空就直接取（里面都等于 last）；
+//    否则找到第一个非空的桶，以其中的最小值作为新的 last，把这个桶的元素重新分桶
+//    新 last 和桶中元素的最高不同位一定更低，所以它们都会落到更小的桶里，每个元素最多下降 位数 次
+//    均摊下来 extractMin 是 O(log C)，C 是键值的范围，比较次数和堆的大小无关
+
+// 和二叉堆相比，基数堆只用到整数的位运算，没有 O(log n) 的逐层比较；桶是连续的 vector，重新分桶是顺序扫描
+
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Key 必须是无符号整数类型，Value 是附带的数据（例如 Dijkstra 中的顶点编号）
+template<class Value, class Key = unsigned int>
+class RadixHeap {
+    static_assert(std::is_unsigned<Key>::value, "RadixHeap keys must be unsigned integers");
+
+private:
+    static constexpr int KEY_BITS = sizeof(Key) * 8;
+
+    std::vector<std::pair<Key, Value>> buckets[KEY_BITS + 1];
+    Key last;      // 最近一次取出的最小键值
+    int currentSize;
+
+    // x 的二进制位数，x == 0 时为 0
+    static int bitWidth(Key x) {
+#if defined(__GNUC__)
+        if (x == 0) {
+            return 0;
+        }
+        if (sizeof(Key) <= sizeof(unsigned int)) {
+            return sizeof(unsigned int) * 8 - __builtin_clz(static_cast<unsigned int>(x));
+        }
+        return sizeof(unsigned long long) * 8 - __builtin_clzll(static_cast<unsigned long long>(x));
+#else
+        int width = 0;
+        while (x != 0) {
+            x >>= 1;
+            ++width;
+        }
+        return width;
+#endif
+    }
+
+    int bucketIndex(Key key) const {
+        return bitWidth(key ^ last);
+    }
+
+    // 0 号桶为空时，找到第一个非空的桶，更新 last 并把它的元素重新分桶，之后 0 号桶一定非空
+    void pull() {
+        if (!buckets[0].empty()) {
+            return;
+        }
+        int i = 1;
+        while (buckets[i].empty()) {
+            ++i;
+        }
+        Key newLast = buckets[i][0].first;
+        for (const auto &item : buckets[i]) {
+            if (item.first < newLast) {
+                newLast = item.first;
+            }
+        }
+        last = newLast;
+        for (auto &item : buckets[i]) {
+            buckets[bucketIndex(item.first)].push_back(std::move(item));
+        }
+        buckets[i].clear();    // 保留容量，下次不用重新分配
+    }
+
+public:
+    RadixHeap() : last(0), currentSize(0) {}
+
+    bool isEmpty() const {
+        return currentSize == 0;
+    }
+
+    int size() const {
+        return currentSize;
+    }
+
+    // 插入的键值不能小于最近一次取出的最小键值，否则抛出 std::invalid_argument
+    void insert(Key key, const Value &value) {
+        if (key < last) {
+            throw std::invalid_argument("RadixHeap: key is smaller than the last extracted key.");
+        }
+        buckets[bucketIndex(key)].emplace_back(key, value);
+        ++currentSize;
+    }
+
+    // 返回最小的键值，之后 insert 的键值不能比它小
+    Key minKey() {
+        if (isEmpty()) {
+            throw std::runtime_error("RadixHeap is empty. Cannot get min key.");
+        }
+        pull();
+        return last;
+    }
+
+    // 删除并返回一个键值最小的 (key, value)
+    std::pair<Key, Value> extractMin() {
+        if (isEmpty()) {
+            throw std::runtime_error("RadixHeap is empty. Cannot extract min.");
+        }
+        pull();
+        std::pair<Key, Value> result = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        --currentSize;
+        return result;
+    }
+
+    // 清空，last 回到 0
+    void clear() {
+        for (auto &bucket : buckets) {
+            bucket.clear();
+        }
+        last = 0;
+        currentSize = 0;
+    }
+};
+
+// 其他文件会直接 #include 本文件来复用 RadixHeap
+// 它们在 #include 之前定义 RADIX_HEAP_NO_MAIN，跳过下面的 main
+#ifndef RADIX_HEAP_NO_MAIN
+
+int main() {
+    RadixHeap<char> heap;
+    std::cout << "Inserting (5,a), (3,b), (9,c), (3,d), (12,e)..." << std::endl;
+    heap.insert(5, 'a');
+    heap.insert(3, 'b');
+    heap.insert(9, 'c');
+    heap.insert(3, 'd');
+    heap.insert(12, 'e');
+
+    std::cout << "Min key: " << heap.minKey() << std::endl;    // 3
+
+    // 单调：取出 3 之后还能插入 >= 3 的键值
+    auto first = heap.extractMin();
+    std::cout << "Extracted " << first.first << ":" << first.second << ", inserting (4,f)..." << std::endl;
+    heap.insert(4, 'f');
+
+    try {
+        heap.insert(2, 'g');
+    } catch (const std::invalid_argument &e) {
+        std::cout << "Inserting (2,g) failed: " << e.what() << std::endl;
+    }
+
+    std::cout << "Extract order (key:value): ";
+    while (!heap.isEmpty()) {
+        auto item = heap.extractMin();
+        std::cout << item.first << ":" << item.second << " ";
+    }
+    std::cout << std::endl;    // 3 4 5 9 12
+
+    return 0;
+}
+
+#endif    // RADIX_HEAP_NO_MAIN
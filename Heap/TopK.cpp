@@ -0,0 +1,167 @@
+// 流式 top-k：在一个很长的数据流里找出最大的 k 个元素
+// 不需要把整个流读进内存再排序（O(n log n) 时间、O(n) 空间），只维护一个大小为 k 的最小堆：
+// 堆顶是目前留下的 k 个元素中最小的那个，也就是“进入前 k 的门槛”
+// 1. 堆还没满：直接插入
+// 2. 堆满了：新元素不比堆顶大，直接丢掉（绝大多数元素走这条路，只有一次比较）；
+//    否则它挤掉堆顶，用 replaceTop 一次下沉完成“弹出 + 压入”
+// 总共 O(n log k) 时间，O(k) 空间，输入只需要是 input iterator（例如 std::istream_iterator），只读一遍
+
+// Compare 决定“大”的含义：默认 std::less，保留最大的 k 个；传 std::greater 则保留最小的 k 个
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#define BINARY_HEAP_NO_MAIN
+#include "BinaryHeap.cpp"
+
+template<class T, class Compare = std::less<T>>
+class TopK {
+private:
+    int k;
+    Compare comp;
+    MinHeap<T, Compare> heap;    // comp 意义下的最小堆，堆顶是门槛
+
+public:
+    explicit TopK(int k, const Compare &compare = Compare()) : k(k), comp(compare), heap(compare) {
+        if (k <= 0) {
+            throw std::invalid_argument("TopK: k must be positive.");
+        }
+    }
+
+    // 处理流中的一个元素
+    void offer(const T &value) {
+        if (heap.size() < k) {
+            heap.insert(value);
+        } else if (comp(heap.peek(), value)) {
+            heap.replaceTop(value);
+        }
+    }
+
+    // 处理 [first, last) 中的所有元素，只要求 input iterator
+    template<class InputIt>
+    void offer(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            offer(*first);
+        }
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    // 当前的门槛：留下的元素中最小的那个，新元素必须比它大才能进入前 k。还没有元素时抛出 std::runtime_error
+    const T &threshold() const {
+        return heap.peek();
+    }
+
+    // 返回留下的元素，从大到小排列，不影响之后继续 offer
+    std::vector<T> result() const {
+        MinHeap<T, Compare> copy = heap;
+        std::vector<T> sorted(copy.size());
+        for (int i = copy.size() - 1; i >= 0; --i) {
+            sorted[i] = copy.extractMin();
+        }
+        return sorted;
+    }
+};
+
+// 一次性版本：[first, last) 中最大的 k 个元素，从大到小排列
+template<class InputIt, class Compare = std::less<typename std::iterator_traits<InputIt>::value_type>>
+std::vector<typename std::iterator_traits<InputIt>::value_type> topK(InputIt first, InputIt last, int k,
+                                                                      const Compare &compare = Compare()) {
+    TopK<typename std::iterator_traits<InputIt>::value_type, Compare> accumulator(k, compare);
+    accumulator.offer(first, last);
+    return accumulator.result();
+}
+
+// 其他文件会直接 #include 本文件来复用 TopK
+// 它们在 #include 之前定义 TOP_K_NO_MAIN，跳过下面的测试代码和 main
+#ifndef TOP_K_NO_MAIN
+
+// 在同一组数据上比较：
+// 1. TopK（replaceTop）
+// 2. 同样的 k 大小的堆，但用 extractMin + insert 代替 replaceTop
+// 3. 全部读进来再 std::partial_sort
+void benchmarkTopK(const std::vector<int> &values, int k) {
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> byReplace = topK(values.begin(), values.end(), k);
+    auto replaceDone = std::chrono::steady_clock::now();
+
+    MinHeap<int> heap;
+    for (int v : values) {
+        if (heap.size() < k) {
+            heap.insert(v);
+        } else if (heap.peek() < v) {
+            heap.extractMin();
+            heap.insert(v);
+        }
+    }
+    std::vector<int> byPopPush(heap.size());
+    for (int i = heap.size() - 1; i >= 0; --i) {
+        byPopPush[i] = heap.extractMin();
+    }
+    auto popPushDone = std::chrono::steady_clock::now();
+
+    std::vector<int> copy = values;
+    std::partial_sort(copy.begin(), copy.begin() + k, copy.end(), std::greater<int>());
+    copy.resize(k);
+    auto partialSortDone = std::chrono::steady_clock::now();
+
+    bool same = byReplace == byPopPush && byReplace == copy;
+    std::cout << "  k = " << k << ": replaceTop " << ms(start, replaceDone) << " ms, extractMin + insert "
+              << ms(replaceDone, popPushDone) << " ms, partial_sort " << ms(popPushDone, partialSortDone) << " ms, "
+              << (same ? "same result" : "RESULTS DIFFER") << std::endl;
+}
+
+int main() {
+    // 从输入流读入，边读边处理，不保存整个流
+    std::istringstream stream("42 7 19 88 3 56 91 23 64 15 77 8");
+    TopK<int> top3(3);
+    top3.offer(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+    std::cout << "Top 3 of the stream: ";
+    for (int v : top3.result()) {
+        std::cout << v << " ";
+    }
+    std::cout << "(threshold " << top3.threshold() << ")" << std::endl;    // 91 88 77
+
+    std::vector<int> values = {42, 7, 19, 88, 3, 56, 91, 23, 64, 15, 77, 8};
+    std::cout << "Smallest 4: ";
+    for (int v : topK(values.begin(), values.end(), 4, std::greater<int>())) {
+        std::cout << v << " ";
+    }
+    std::cout << std::endl;    // 3 7 8 15
+
+    // 前期几乎每个元素都会进堆，后期门槛越来越高，大部分元素只比较一次就丢掉
+    // 为了让 replaceTop 的作用更明显，这里还测一组递增的数据：每个元素都会挤掉堆顶
+    const int N = 1 << 24;
+    std::vector<int> randomValues(N);
+    std::vector<int> increasing(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        randomValues[i] = static_cast<int>(seed >> 2);
+        increasing[i] = i;
+    }
+    std::cout << "\n--- Top-k of 2^24 random ints ---" << std::endl;
+    for (int k : {10, 1000, 100000}) {
+        benchmarkTopK(randomValues, k);
+    }
+    std::cout << "\n--- Top-k of 2^24 increasing ints (every element replaces the top) ---" << std::endl;
+    for (int k : {10, 1000, 100000}) {
+        benchmarkTopK(increasing, k);
+    }
+
+    return 0;
+}
+
+#endif    // TOP_K_NO_MAIN
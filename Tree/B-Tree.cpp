@@ -1,12 +1,20 @@
 // 以最小度为定义的B树实现：对于M阶B树，最多有M-1个key和M个子节点
 // 其阶数为2t
 // 注意一个性质：对于非叶子结点，如果有n个键，则必然有n+1个子节点
+// 文件后半部分的 FixedBTree 是同样算法的 cache 友好版本：节点是定长数组，节点内查找无分支
 
-#include <algorithm>    // For std::sort, std::find
+#include <algorithm>      // For std::sort, std::find
+#include <chrono>         // For 节点布局对比的计时
 #include <iostream>
-#include <stdexcept>    // For std::invalid_argument
+#include <limits>         // For std::numeric_limits
+#include <stdexcept>      // For std::invalid_argument
+#include <type_traits>    // For std::is_arithmetic
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>    // For SSE2，x86-64 上总是可用
+#endif
+
 // 模板类 BTree
 template<typename T>
 class BTree {
@@ -494,6 +502,398 @@ public:
     }
 };
 
+// 计算把 count 个 Elem 向上取整到 64 字节（一个 cache line）的整数倍之后，一共能放下多少个 Elem
+template<typename Elem>
+constexpr int cacheLineSlots(int count) {
+    return static_cast<int>((count * sizeof(Elem) + 63) / 64 * 64 / sizeof(Elem));
+}
+
+// 模板类 FixedBTree：和 BTree 的算法完全相同（插入时主动分裂，删除时主动填充），只是节点布局不同
+// BTree 的节点里有两个 vector，每个节点要 3 次堆分配，键和子节点指针散落在三块内存里，每访问一个节点至少 3 次 cache miss
+// 这里最小度数 t 是模板参数，节点里直接放定长数组：
+// 1. 一个节点只有一次分配，整个节点按 cache line 对齐，键数组和子节点数组都向上取整到整 cache line
+// 2. 算术类型的键，空余的键位置填上哨兵（整数是 numeric_limits<T>::max()，浮点数是 +infinity），节点内查找可以不看键的个数，
+//    对整个定长数组做无分支查找：
+//    - 键数组不超过 4 个 cache line 时，直接统计“有多少个键小于 k”，循环次数是编译期常数，没有分支；
+//      int 键在 x86-64 上用 SSE2 一次比较 4 个，其他算术类型交给编译器自动向量化（-O3）
+//    - 更大时用无分支的二分查找：每次只根据比较结果移动起点（编译成条件传送），不会分支预测失败
+//    哨兵必须不小于任何合法的键，否则查找结果会越过 n。浮点数的 max() 比 +infinity 小，所以用 infinity；
+//    NaN 和任何数比较都是 false，无法排序，insert 时直接拒绝
+// 3. 其他类型的键仍然用 std::lower_bound
+// 代价是每个节点总是占满 2t - 1 个键的空间，平均填充率一般在 70% 左右，内存用得比 vector 版本多一些
+template<typename T, int t>
+class FixedBTree {
+    static_assert(t >= 2, "Minimum degree (t) must be at least 2.");
+
+private:
+    static constexpr int MAX_KEYS = 2 * t - 1;
+    static constexpr int KEY_SLOTS = cacheLineSlots<T>(MAX_KEYS);
+    static constexpr int CHILD_SLOTS = cacheLineSlots<void *>(2 * t);
+    static constexpr bool BRANCHLESS = std::is_arithmetic<T>::value;
+
+    // 空余键位置的哨兵，不小于任何可以插入的键
+    static constexpr T sentinel() {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::max();
+        }
+    }
+
+    struct alignas(64) Node {
+        T keys[KEY_SLOTS];                       // keys[0 .. n-1] 是键；算术类型时 keys[n .. KEY_SLOTS-1] 是哨兵
+        alignas(64) Node *children[CHILD_SLOTS];    // children[0 .. n] 是子节点，叶子节点不使用
+        int n;                                   // 当前键的个数
+        bool isLeaf;
+
+        explicit Node(bool leaf) : n(0), isLeaf(leaf) {
+            if constexpr (BRANCHLESS) {
+                std::fill(keys, keys + KEY_SLOTS, sentinel());
+            }
+        }
+
+        // 键的个数减少到 count，空出来的位置重新填上哨兵
+        void shrinkTo(int count) {
+            if constexpr (BRANCHLESS) {
+                std::fill(keys + count, keys + n, sentinel());
+            }
+            n = count;
+        }
+
+        // 第一个大于或等于 k 的键的索引，没有则返回 n
+        // 哨兵不小于任何 k，所以在整个定长数组上查找，结果不会超过 n
+        int findKey(const T &k) const {
+            if constexpr (BRANCHLESS) {
+                if constexpr (KEY_SLOTS * sizeof(T) <= 256) {
+#ifdef __SSE2__
+                    if constexpr (std::is_same<T, int>::value) {
+                        // 一次比较 4 个 int：小于 k 的位置得到 -1，全部累加后取相反数就是个数
+                        // KEY_SLOTS 是 16 的倍数，keys 在节点开头，按 64 字节对齐，可以用对齐的读取
+                        __m128i key = _mm_set1_epi32(k);
+                        __m128i sum = _mm_setzero_si128();
+                        for (int i = 0; i < KEY_SLOTS; i += 4) {
+                            __m128i block = _mm_load_si128(reinterpret_cast<const __m128i *>(keys + i));
+                            sum = _mm_add_epi32(sum, _mm_cmplt_epi32(block, key));
+                        }
+                        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+                        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+                        return -_mm_cvtsi128_si32(sum);
+                    }
+#endif
+                    int idx = 0;
+                    for (int i = 0; i < KEY_SLOTS; ++i) {
+                        idx += keys[i] < k;
+                    }
+                    return idx;
+                } else {
+                    const T *base = keys;
+                    int len = KEY_SLOTS;
+                    while (len > 1) {
+                        int half = len / 2;
+                        base = (base[half] < k) ? base + half : base;
+                        len -= half;
+                    }
+                    return static_cast<int>(base - keys) + (*base < k);
+                }
+            } else {
+                return static_cast<int>(std::lower_bound(keys, keys + n, k) - keys);
+            }
+        }
+
+        // 中序遍历
+        void traverse() const {
+            for (int i = 0; i < n; ++i) {
+                if (!isLeaf) {
+                    children[i]->traverse();
+                }
+                std::cout << keys[i] << " ";
+            }
+            if (!isLeaf) {
+                children[n]->traverse();
+            }
+        }
+
+        // 插入非满节点，沿途遇到满的子节点先分裂，保证下去之后一定放得下
+        void insertNonFull(const T &k) {
+            Node *node = this;
+            while (!node->isLeaf) {
+                int i = node->findKey(k);
+                if (node->children[i]->n == MAX_KEYS) {
+                    node->splitChild(i, node->children[i]);
+                    // 刚升上来的键在 keys[i]，判断 k 应该去它的哪一边
+                    if (node->keys[i] < k) {
+                        ++i;
+                    }
+                }
+                node = node->children[i];
+            }
+            int i = node->findKey(k);
+            std::copy_backward(node->keys + i, node->keys + node->n, node->keys + node->n + 1);
+            node->keys[i] = k;
+            ++node->n;
+        }
+
+        // 分裂满的子节点 fullChild (位于 children[i])，下标划分和 BTree::BTreeNode::splitChild 相同
+        void splitChild(int i, Node *fullChild) {
+            Node *newChild = new Node(fullChild->isLeaf);
+
+            // 当前节点的 keys[i ..] 和 children[i + 1 ..] 右移一格，腾出位置给提升的键和新节点
+            std::copy_backward(children + i + 1, children + n + 1, children + n + 2);
+            children[i + 1] = newChild;
+            std::copy_backward(keys + i, keys + n, keys + n + 1);
+            keys[i] = fullChild->keys[t - 1];
+            ++n;
+
+            // fullChild 的后 t-1 个键和后 t 个子节点移到 newChild
+            std::copy(fullChild->keys + t, fullChild->keys + MAX_KEYS, newChild->keys);
+            newChild->n = t - 1;
+            if (!fullChild->isLeaf) {
+                std::copy(fullChild->children + t, fullChild->children + 2 * t, newChild->children);
+            }
+            fullChild->shrinkTo(t - 1);
+        }
+
+        // 搜索键值 k，非递归
+        bool search(const T &k) const {
+            const Node *node = this;
+            while (true) {
+                int i = node->findKey(k);
+                if (i < node->n && node->keys[i] == k) {
+                    return true;
+                }
+                if (node->isLeaf) {
+                    return false;
+                }
+                node = node->children[i];
+            }
+        }
+
+        T getPredecessor(int idx) const {
+            const Node *curr = children[idx];
+            while (!curr->isLeaf) {
+                curr = curr->children[curr->n];
+            }
+            return curr->keys[curr->n - 1];
+        }
+
+        T getSuccessor(int idx) const {
+            const Node *curr = children[idx + 1];
+            while (!curr->isLeaf) {
+                curr = curr->children[0];
+            }
+            return curr->keys[0];
+        }
+
+        // 从当前节点删除键值 k，各种情况的说明见 BTree::BTreeNode::remove
+        void remove(const T &k) {
+            int idx = findKey(k);
+            if (idx < n && keys[idx] == k) {
+                if (isLeaf) {
+                    std::copy(keys + idx + 1, keys + n, keys + idx);
+                    shrinkTo(n - 1);
+                } else if (children[idx]->n >= t) {
+                    T pred = getPredecessor(idx);
+                    keys[idx] = pred;
+                    children[idx]->remove(pred);
+                } else if (children[idx + 1]->n >= t) {
+                    T succ = getSuccessor(idx);
+                    keys[idx] = succ;
+                    children[idx + 1]->remove(succ);
+                } else {
+                    merge(idx);
+                    children[idx]->remove(k);
+                }
+            } else {
+                if (isLeaf) {
+                    return;
+                }
+                bool flag = (idx == n);
+                if (children[idx]->n == t - 1) {
+                    fill(idx);
+                }
+                if (flag && idx > n) {
+                    children[idx - 1]->remove(k);
+                } else {
+                    children[idx]->remove(k);
+                }
+            }
+        }
+
+        void fill(int idx) {
+            if (idx != 0 && children[idx - 1]->n >= t) {
+                borrowFromPrev(idx);
+            } else if (idx != n && children[idx + 1]->n >= t) {
+                borrowFromNext(idx);
+            } else if (idx != n) {
+                merge(idx);
+            } else {
+                merge(idx - 1);
+            }
+        }
+
+        void borrowFromPrev(int idx) {
+            Node *child = children[idx];
+            Node *sibling = children[idx - 1];
+
+            std::copy_backward(child->keys, child->keys + child->n, child->keys + child->n + 1);
+            child->keys[0] = keys[idx - 1];
+            if (!child->isLeaf) {
+                std::copy_backward(child->children, child->children + child->n + 1, child->children + child->n + 2);
+                child->children[0] = sibling->children[sibling->n];
+            }
+            ++child->n;
+
+            keys[idx - 1] = sibling->keys[sibling->n - 1];
+            sibling->shrinkTo(sibling->n - 1);
+        }
+
+        void borrowFromNext(int idx) {
+            Node *child = children[idx];
+            Node *sibling = children[idx + 1];
+
+            child->keys[child->n] = keys[idx];
+            if (!child->isLeaf) {
+                child->children[child->n + 1] = sibling->children[0];
+            }
+            ++child->n;
+
+            keys[idx] = sibling->keys[0];
+            std::copy(sibling->keys + 1, sibling->keys + sibling->n, sibling->keys);
+            if (!sibling->isLeaf) {
+                std::copy(sibling->children + 1, sibling->children + sibling->n + 1, sibling->children);
+            }
+            sibling->shrinkTo(sibling->n - 1);
+        }
+
+        // 合并 children[idx]、keys[idx] 和 children[idx+1]
+        void merge(int idx) {
+            Node *child = children[idx];
+            Node *sibling = children[idx + 1];
+
+            child->keys[child->n] = keys[idx];
+            std::copy(sibling->keys, sibling->keys + sibling->n, child->keys + child->n + 1);
+            if (!child->isLeaf) {
+                std::copy(sibling->children, sibling->children + sibling->n + 1, child->children + child->n + 1);
+            }
+            child->n += sibling->n + 1;
+
+            std::copy(keys + idx + 1, keys + n, keys + idx);
+            std::copy(children + idx + 2, children + n + 1, children + idx + 1);
+            shrinkTo(n - 1);
+
+            delete sibling;    // Node 没有析构函数，不会连带删除已经转移给 child 的子节点
+        }
+    };
+
+    Node *root;
+
+    static void destroy(Node *node) {
+        if (!node->isLeaf) {
+            for (int i = 0; i <= node->n; ++i) {
+                destroy(node->children[i]);
+            }
+        }
+        delete node;
+    }
+
+public:
+    FixedBTree() : root(nullptr) {}
+
+    FixedBTree(const FixedBTree &) = delete;
+    FixedBTree &operator=(const FixedBTree &) = delete;
+
+    ~FixedBTree() {
+        if (root != nullptr) {
+            destroy(root);
+        }
+    }
+
+    void traverse() const {
+        if (root != nullptr) {
+            root->traverse();
+        } else {
+            std::cout << "The tree is empty.";
+        }
+        std::cout << std::endl;
+    }
+
+    bool search(const T &k) const {
+        return root != nullptr && root->search(k);
+    }
+
+    // 浮点数的 NaN 无法排序，抛出 std::invalid_argument
+    void insert(const T &k) {
+        if constexpr (std::is_floating_point<T>::value) {
+            if (k != k) {
+                throw std::invalid_argument("FixedBTree: NaN keys cannot be ordered.");
+            }
+        }
+        if (root == nullptr) {
+            root = new Node(true);
+        } else if (root->n == MAX_KEYS) {
+            Node *s = new Node(false);
+            s->children[0] = root;
+            s->splitChild(0, root);
+            root = s;
+        }
+        root->insertNonFull(k);
+    }
+
+    void remove(const T &k) {
+        if (!root) {
+            std::cout << "The tree is empty. Cannot delete.\n";
+            return;
+        }
+        root->remove(k);
+        if (root->n == 0) {
+            Node *oldRoot = root;
+            root = root->isLeaf ? nullptr : oldRoot->children[0];
+            delete oldRoot;
+        }
+    }
+
+    // 每个节点占用的字节数
+    static constexpr size_t nodeBytes() {
+        return sizeof(Node);
+    }
+};
+
+// 同一组随机键，分别插入 BTree<int>(t) 和 FixedBTree<int, t>，再做同样的查找（一半存在、一半不存在）
+template<int t>
+void benchmarkNodeLayout(const std::vector<int> &keys, const std::vector<int> &queries) {
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    BTree<int> vectorTree(t);
+    for (int k : keys) {
+        vectorTree.insert(k);
+    }
+    auto vectorInserted = std::chrono::steady_clock::now();
+    int vectorFound = 0;
+    for (int q : queries) {
+        vectorFound += vectorTree.search(q) != nullptr;
+    }
+    auto vectorSearched = std::chrono::steady_clock::now();
+
+    FixedBTree<int, t> fixedTree;
+    for (int k : keys) {
+        fixedTree.insert(k);
+    }
+    auto fixedInserted = std::chrono::steady_clock::now();
+    int fixedFound = 0;
+    for (int q : queries) {
+        fixedFound += fixedTree.search(q);
+    }
+    auto fixedSearched = std::chrono::steady_clock::now();
+
+    std::cout << "  t = " << t << " (节点 " << FixedBTree<int, t>::nodeBytes() << " 字节): 插入 vector "
+              << ms(start, vectorInserted) << " ms / 定长 " << ms(vectorSearched, fixedInserted) << " ms，查找 vector "
+              << ms(vectorInserted, vectorSearched) << " ms / 定长 " << ms(fixedInserted, fixedSearched) << " ms，"
+              << (vectorFound == fixedFound ? "结果一致" : "结果不一致") << std::endl;
+}
+
 // --- 测试代码 ---
 int main() {
     // 创建一个最小度数为 3 的B树
@@ -620,5 +1020,54 @@ int main() {
     std::cout << "B树中序遍历结果：\n";
     t.traverse();    // 此时树应该为空
 
+    std::cout << "\n--- FixedBTree 测试 ---\n";
+    FixedBTree<int, 3> fixed;
+    for (int key = 1; key <= 40; ++key) {
+        fixed.insert(key * 7 % 41);
+    }
+    for (int key : {6, 13, 7, 20, 10, 30}) {
+        fixed.remove(key);
+    }
+    std::cout << "插入 1 ~ 40 后删除 6, 13, 7, 20, 10, 30，中序遍历结果：\n";
+    fixed.traverse();
+    std::cout << "6 " << (fixed.search(6) ? "存在" : "不存在") << "于B树中，8 " << (fixed.search(8) ? "存在" : "不存在")
+              << "于B树中。\n";
+
+    // 浮点键：+infinity 和 max() 都必须落在哨兵之前，NaN 被拒绝
+    FixedBTree<double, 4> real;
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int key = 0; key < 50; ++key) {
+        real.insert(key);
+    }
+    real.insert(inf);
+    real.insert(std::numeric_limits<double>::max());
+    real.insert(-inf);
+    std::cout << "插入 0 ~ 49、+inf、DBL_MAX、-inf 后，+inf " << (real.search(inf) ? "存在" : "不存在")
+              << "于B树中，-inf " << (real.search(-inf) ? "存在" : "不存在") << "于B树中。\n";
+    try {
+        real.insert(std::numeric_limits<double>::quiet_NaN());
+    } catch (const std::invalid_argument &e) {
+        std::cout << "插入 NaN 失败：" << e.what() << "\n";
+    }
+
+    // 1000000 个随机键插入，再查找 1000000 次
+    std::cout << "\n--- 节点布局对比：vector 节点 vs 定长数组节点 ---\n";
+    const int N = 1000000;
+    std::vector<int> keys(N), queries(N);
+    unsigned seed = 2024;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        keys[i] = static_cast<int>(seed >> 2);
+    }
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        queries[i] = (i % 2 == 0) ? keys[seed % N] : static_cast<int>(seed >> 2);
+    }
+    benchmarkNodeLayout<4>(keys, queries);
+    benchmarkNodeLayout<8>(keys, queries);
+    benchmarkNodeLayout<16>(keys, queries);
+    benchmarkNodeLayout<32>(keys, queries);
+    benchmarkNodeLayout<64>(keys, queries);
+
     return 0;
 }